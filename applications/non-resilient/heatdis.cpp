@@ -1,15 +1,17 @@
 #include "heatdis.hpp"
 
 namespace heatdis {
-    void initData(std::size_t nbLines, std::size_t M, std::size_t rank,
-        Kokkos::View<double*> h)
+    template <typename ExecutionSpace>
+    void initData(ExecutionSpace const& inst, std::size_t nbLines,
+        std::size_t M, std::size_t rank, view_type<ExecutionSpace> h)
     {
-        using range_policy = Kokkos::RangePolicy<>;
-        using mdrange_policy = Kokkos::MDRangePolicy<Kokkos::Rank<2>>;
+        using range_policy = Kokkos::RangePolicy<ExecutionSpace>;
+        using mdrange_policy =
+            Kokkos::MDRangePolicy<ExecutionSpace, Kokkos::Rank<2>>;
 
         /* set all of the data to 0 */
         Kokkos::parallel_for(
-            "init_h", mdrange_policy({0u, 0u}, {nbLines, M}),
+            "init_h", mdrange_policy(inst, {0u, 0u}, {nbLines, M}),
             KOKKOS_LAMBDA(
                 std::size_t i, std::size_t j) { h((i * M) + j) = 0; });
 
@@ -18,32 +20,38 @@ namespace heatdis {
         {
             int j = ceil(M * 0.9);
             Kokkos::parallel_for(
-                "init_rank0", range_policy((std::size_t)(M * 0.1), j),
+                "init_rank0", range_policy(inst, (std::size_t)(M * 0.1), j),
                 KOKKOS_LAMBDA(std::size_t i) { h(i) = 100; });
         }
     }
 
-    double doWork(std::size_t numprocs, std::size_t rank, std::size_t M,
-        std::size_t nbLines, Kokkos::View<double*> g, Kokkos::View<double*> h)
+    template <typename ExecutionSpace>
+    double doWork(ExecutionSpace const& inst, std::size_t numprocs,
+        std::size_t rank, std::size_t M, std::size_t nbLines,
+        view_type<ExecutionSpace> g, view_type<ExecutionSpace> h)
     {
         MPI_Request req1[2], req2[2];
         MPI_Status status1[2], status2[2];
 
-        Kokkos::View<double*> localerror("localerror", 1);
+        view_type<ExecutionSpace> localerror("localerror", 1);
         Kokkos::View<double*, Kokkos::DefaultHostExecutionSpace>
             localerror_host("localerror_host", 1);
         localerror_host[0] = 0.;
         Kokkos::deep_copy(localerror, localerror_host);
 
-        using range_policy = Kokkos::RangePolicy<>;
-        using mdrange_policy = Kokkos::MDRangePolicy<Kokkos::Rank<2>>;
+        using range_policy = Kokkos::RangePolicy<ExecutionSpace>;
+        using mdrange_policy =
+            Kokkos::MDRangePolicy<ExecutionSpace, Kokkos::Rank<2>>;
 
         Kokkos::parallel_for(
-            "copy_g", mdrange_policy({0u, 0u}, {nbLines, M}),
+            "copy_g", mdrange_policy(inst, {0u, 0u}, {nbLines, M}),
             KOKKOS_LAMBDA(std::size_t i, std::size_t j) {
                 h((i * M) + j) = g((i * M) + j);
             });
 
+        /* MPI reads g and writes the halo rows of h */
+        inst.fence();
+
         double* g_raw = g.data();
         double* h_raw = h.data();
 
@@ -80,7 +88,7 @@ namespace heatdis {
 
         /* perform the computation */
         Kokkos::parallel_for(
-            "compute", mdrange_policy({1u, 0u}, {nbLines - 1, M}),
+            "compute", mdrange_policy(inst, {1u, 0u}, {nbLines - 1, M}),
             KOKKOS_LAMBDA(std::size_t i, std::size_t j) {
                 g((i * M) + j) = 0.25 *
                     (h(((i - 1) * M) + j) + h(((i + 1) * M) + j) +
@@ -97,7 +105,8 @@ namespace heatdis {
         if (rank == (numprocs - 1))
         {
             Kokkos::parallel_for(
-                "compute_right", range_policy(0, M), KOKKOS_LAMBDA(int j) {
+                "compute_right", range_policy(inst, 0, M),
+                KOKKOS_LAMBDA(int j) {
                     g(((nbLines - 1) * M) + j) = g(((nbLines - 2) * M) + j);
 
                     return g(((nbLines - 1) * M) + j);
@@ -108,4 +117,28 @@ namespace heatdis {
 
         return localerror_host[0];
     }
+
+#define HEATDIS_INSTANTIATE(SPACE)                                             \
+    template void initData<SPACE>(SPACE const&, std::size_t, std::size_t,      \
+        std::size_t, view_type<SPACE>);                                        \
+    template double doWork<SPACE>(SPACE const&, std::size_t, std::size_t,      \
+        std::size_t, std::size_t, view_type<SPACE>, view_type<SPACE>);
+
+#if defined(KOKKOS_ENABLE_SERIAL)
+    HEATDIS_INSTANTIATE(Kokkos::Serial)
+#endif
+#if defined(KOKKOS_ENABLE_OPENMP)
+    HEATDIS_INSTANTIATE(Kokkos::OpenMP)
+#endif
+#if defined(KOKKOS_ENABLE_THREADS)
+    HEATDIS_INSTANTIATE(Kokkos::Threads)
+#endif
+#if defined(KOKKOS_ENABLE_CUDA)
+    HEATDIS_INSTANTIATE(Kokkos::Cuda)
+#endif
+#if defined(KOKKOS_ENABLE_HIP)
+    HEATDIS_INSTANTIATE(Kokkos::Experimental::HIP)
+#endif
+
+#undef HEATDIS_INSTANTIATE
 }    // namespace heatdis
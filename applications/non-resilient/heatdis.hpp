@@ -14,11 +14,18 @@
 #define REDUCED 1
 
 namespace heatdis {
-    void initData(std::size_t nbLines, std::size_t M, std::size_t rank,
-        Kokkos::View<double*> h);
+    template <typename ExecutionSpace>
+    using view_type =
+        Kokkos::View<double*, typename ExecutionSpace::memory_space>;
 
-    double doWork(std::size_t numprocs, std::size_t rank, std::size_t M,
-        std::size_t nbLines, Kokkos::View<double*> g, Kokkos::View<double*> h);
+    template <typename ExecutionSpace>
+    void initData(ExecutionSpace const& inst, std::size_t nbLines,
+        std::size_t M, std::size_t rank, view_type<ExecutionSpace> h);
+
+    template <typename ExecutionSpace>
+    double doWork(ExecutionSpace const& inst, std::size_t numprocs,
+        std::size_t rank, std::size_t M, std::size_t nbLines,
+        view_type<ExecutionSpace> g, view_type<ExecutionSpace> h);
 }    // namespace heatdis
 
 #endif    // INC_HEATDIS_HEATDIS_HPP
@@ -26,31 +26,37 @@ KOKKOS_FUNCTION double stencil6p(double self, double xm, double xp, double ym,
     return (1.0 - 6.0 * cfl) * self + cfl * (xm + xp + ym + yp + zm + zp);
 }
 
+// Validates a whole timestep: the checksum updated by the boundary flux
+// kernels must match the sum of the new stencil.
+using accumulator_type = Kokkos::resilience::util::Accumulator<double>;
+
 struct validator
 {
-    validator(Kokkos::View<double*, Kokkos::MemoryTraits<Kokkos::Atomic>> const&
-            checksum_)
+    validator(accumulator_type const& checksum_,
+        Kokkos::View<double> const& new_checksum_)
       : checksum(checksum_)
+      , new_checksum(new_checksum_)
     {
     }
 
-    KOKKOS_FUNCTION bool operator()(double& new_checksum) const
+    bool operator()() const
     {
-        Kokkos::View<double*, Kokkos::DefaultHostExecutionSpace> hchecksum(
-            "validator_host", 1);
-        Kokkos::deep_copy(hchecksum, checksum);
+        double const hchecksum = checksum.value();
+
+        double hnew_checksum = 0.;
+        Kokkos::deep_copy(hnew_checksum, new_checksum);
 
-     
-        auto error = std::abs((new_checksum - hchecksum[0]));
+        auto error = std::abs((hnew_checksum - hchecksum));
 
-        std::cout << "New Checksum " << std::scientific << new_checksum
-                  << " and analytical checksum " << hchecksum[0]
+        std::cout << "New Checksum " << std::scientific << hnew_checksum
+                  << " and analytical checksum " << hchecksum
                   << " with Error: " << error << std::endl;
 
         return (error < 1e-2);
     }
 
-    Kokkos::View<double*, Kokkos::MemoryTraits<Kokkos::Atomic>> checksum;
+    accumulator_type checksum;
+    Kokkos::View<double> new_checksum;
 };
 
 int main(int argc, char* argv[])
@@ -82,9 +88,11 @@ int main(int argc, char* argv[])
         Kokkos::DefaultExecutionSpace inst{};
         using range_policy = Kokkos::RangePolicy<>;
 
-        using resilient_range_policy =
-            Kokkos::RangePolicy<Kokkos::resilience::ResilientReplay<
-                Kokkos::DefaultExecutionSpace, validator>>;
+        using range_policy_inst =
+            Kokkos::RangePolicy<Kokkos::DefaultExecutionSpace>;
+        using mdrange_policy_inst =
+            Kokkos::MDRangePolicy<Kokkos::DefaultExecutionSpace,
+                Kokkos::Rank<3>>;
         using resilient_space =
             Kokkos::resilience::ResilientReplay<Kokkos::DefaultExecutionSpace,
                 validator>;
@@ -98,16 +106,11 @@ int main(int argc, char* argv[])
         auto stencil_old = stencil_0;
         auto stencil_new = stencil_1;
         auto stencil_tmp = stencil_new;
-        Kokkos::View<double*, Kokkos::MemoryTraits<Kokkos::Atomic>> checksum(
-            "checksum", 1);
-
-        double chk_ = 0.;
+        // Per-thread partials instead of a contended atomic, contributions
+        // of a replayed timestep are discarded
+        accumulator_type checksum("checksum", inst);
 
-        Kokkos::View<double*, Kokkos::DefaultHostExecutionSpace> hchecksum(
-            "h_checksum", 1);
-        hchecksum[0] = 0.;
-
-        Kokkos::deep_copy(checksum, hchecksum);
+        Kokkos::View<double> chk_("new_checksum");
         // Kokkos::deep_copy(chk_, hchk_);
 
         // Initialize stencil
@@ -139,87 +142,81 @@ int main(int argc, char* argv[])
                 {
                     for (int k = 1; k <= zsize; ++k)
                     {
-                        checksum[0] += stencil_old(i, j, k);
+                        checksum.add(stencil_old(i, j, k));
                     }
                 }
             });
         Kokkos::fence();
 
-        Kokkos::deep_copy(hchecksum, checksum);
+        checksum.commit();
 
-        std::cout << "Initial Checksum " << std::scientific << hchecksum[0]
+        std::cout << "Initial Checksum " << std::scientific << checksum.value()
                   << std::endl;
 
         for (int its = 0; its < 10; ++its)
         {
             //std::cout << " Point (0,0,0)  " << stencil_old(0,0,0) << " Point (32,40,0)  " << stencil_old (32,40,0) << std::endl;
+            // All kernels of a timestep are validated once and replayed
+            // together, pending checksum contributions are discarded first.
+            Kokkos::resilience::ResilientTransaction<
+                Kokkos::DefaultExecutionSpace, validator>
+                transaction(
+                    resilient_space(3, validator{checksum, chk_}, inst));
+            transaction.enlist(checksum);
+
             // Deduct the checksum from the boundary
-            Kokkos::parallel_for(
-                "first_loop", range_policy(1, zsize + 1), KOKKOS_LAMBDA(int k) {
+            transaction.parallel_for(
+                "first_loop", range_policy_inst(inst, 1, zsize + 1),
+                KOKKOS_LAMBDA(int k) {
                     for (int j = 1; j <= ysize; ++j)
                     {
-                        checksum[0] -= left_flux(stencil_old(0, j, k),
+                        checksum.add(-(left_flux(stencil_old(0, j, k),
                                            stencil_old(1, j, k), cfl) +
                             right_flux(stencil_old(xsize, j, k),
-                                stencil_old(xsize + 1, j, k), cfl);
+                                stencil_old(xsize + 1, j, k), cfl)));
                     }
                 });
-            Kokkos::fence();
 
-            Kokkos::parallel_for(
-                "second_loop", range_policy(1, zsize + 1),
+            transaction.parallel_for(
+                "second_loop", range_policy_inst(inst, 1, zsize + 1),
                 KOKKOS_LAMBDA(int k) {
                     for (int i = 1; i <= xsize; ++i)
                     {
-                        checksum[0] -= left_flux(stencil_old(i, 0, k),
+                        checksum.add(-(left_flux(stencil_old(i, 0, k),
                                            stencil_old(i, 1, k), cfl) +
                             right_flux(stencil_old(i, ysize, k),
-                                stencil_old(i, ysize + 1, k), cfl);
+                                stencil_old(i, ysize + 1, k), cfl)));
                     }
                 });
-            Kokkos::fence();
 
-            Kokkos::parallel_for(
-                "third_loop", range_policy(1, ysize + 1), KOKKOS_LAMBDA(int j) {
+            transaction.parallel_for(
+                "third_loop", range_policy_inst(inst, 1, ysize + 1),
+                KOKKOS_LAMBDA(int j) {
                     for (int i = 1; i <= xsize; ++i)
                     {
-                        checksum[0] -= left_flux(stencil_old(i, j, 0),
+                        checksum.add(-(left_flux(stencil_old(i, j, 0),
                                            stencil_old(i, j, 1), cfl) +
                             right_flux(stencil_old(i, j, zsize),
-                                stencil_old(i, j, zsize + 1), cfl);
+                                stencil_old(i, j, zsize + 1), cfl)));
                     }
                 });
-            Kokkos::fence();
-
-            // Apply stencil
-            // Replace the loops by parallel for
-            //
-            Kokkos::parallel_reduce(
-                "stencil_op",
-                resilient_range_policy(
-                    resilient_space(3, validator{checksum}, inst), 1,
-                    xsize + 1),
-                KOKKOS_LAMBDA(int i, double& chk_) {
-                    for (int j = 1; j <= ysize; ++j)
-                    {
-                        for (int k = 1; k <= zsize; ++k)
-                        {
-                            stencil_new(i, j, k) = stencil6p(
-                                stencil_old(i, j, k), stencil_old(i - 1, j, k),
-                                stencil_old(i + 1, j, k),
-                                stencil_old(i, j - 1, k),
-                                stencil_old(i, j + 1, k),
-                                stencil_old(i, j, k - 1),
-                                stencil_old(i, j, k + 1), cfl);
-
-                            chk_ += stencil_new(i, j, k);
-                        }
-                    }
+
+            // Apply stencil as a tiled 3D kernel
+            transaction.parallel_reduce("stencil_op",
+                mdrange_policy_inst(inst, {1, 1, 1},
+                    {xsize + 1, ysize + 1, zsize + 1}),
+                KOKKOS_LAMBDA(int i, int j, int k, double& chk) {
+                    stencil_new(i, j, k) = stencil6p(stencil_old(i, j, k),
+                        stencil_old(i - 1, j, k), stencil_old(i + 1, j, k),
+                        stencil_old(i, j - 1, k), stencil_old(i, j + 1, k),
+                        stencil_old(i, j, k - 1), stencil_old(i, j, k + 1),
+                        cfl);
+
+                    chk += stencil_new(i, j, k);
                 },
-                Kokkos::Sum<double, Kokkos::DefaultHostExecutionSpace>(chk_));
-            Kokkos::fence();
+                chk_);
 
-            chk_ = 0.;
+            transaction.execute();
 
             // Alternate stencil assignment
             if (its % 2 == 0)
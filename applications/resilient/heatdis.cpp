@@ -1,15 +1,17 @@
 #include "heatdis.hpp"
 
 namespace heatdis {
-    void initData(std::size_t nbLines, std::size_t M, std::size_t rank,
-        Kokkos::View<double*> h)
+    template <typename ExecutionSpace>
+    void initData(ExecutionSpace const& inst, std::size_t nbLines,
+        std::size_t M, std::size_t rank, view_type<ExecutionSpace> h)
     {
-        using range_policy = Kokkos::RangePolicy<>;
-        using mdrange_policy = Kokkos::MDRangePolicy<Kokkos::Rank<2>>;
+        using range_policy = Kokkos::RangePolicy<ExecutionSpace>;
+        using mdrange_policy =
+            Kokkos::MDRangePolicy<ExecutionSpace, Kokkos::Rank<2>>;
 
         /* set all of the data to 0 */
         Kokkos::parallel_for(
-            "init_h", mdrange_policy({0u, 0u}, {nbLines, M}),
+            "init_h", mdrange_policy(inst, {0u, 0u}, {nbLines, M}),
             KOKKOS_LAMBDA(
                 std::size_t i, std::size_t j) { h((i * M) + j) = 0; });
 
@@ -18,42 +20,40 @@ namespace heatdis {
         {
             int j = ceil(M * 0.9);
             Kokkos::parallel_for(
-                "init_rank0", range_policy((std::size_t)(M * 0.1), j),
+                "init_rank0", range_policy(inst, (std::size_t)(M * 0.1), j),
                 KOKKOS_LAMBDA(std::size_t i) { h(i) = 100; });
         }
     }
 
-    double doWork(std::size_t numprocs, std::size_t rank, std::size_t M,
-        std::size_t nbLines, Kokkos::View<double*> g, Kokkos::View<double*> h)
+    template <typename ExecutionSpace>
+    void doWork(ExecutionSpace const& inst, std::size_t numprocs,
+        std::size_t rank, std::size_t M, std::size_t nbLines,
+        view_type<ExecutionSpace> g, view_type<ExecutionSpace> h)
     {
         MPI_Request req1[2], req2[2];
         MPI_Status status1[2], status2[2];
 
-        Kokkos::View<double*> localerror("localerror", 1);
-        Kokkos::View<double*, Kokkos::DefaultHostExecutionSpace>
-            localerror_host("localerror_host", 1);
-        localerror_host[0] = 0.;
-        Kokkos::deep_copy(localerror, localerror_host);
-
-        Kokkos::Cuda inst{};
-        Kokkos::resilience::ResilientReplicate<Kokkos::Cuda> replicate_inst(
+        Kokkos::resilience::ResilientReplicate<ExecutionSpace> replicate_inst(
             inst);
 
         using resilient_range_policy = Kokkos::RangePolicy<
-            Kokkos::resilience::ResilientReplicate<Kokkos::Cuda>>;
+            Kokkos::resilience::ResilientReplicate<ExecutionSpace>>;
         using resilient_mdrange_policy = Kokkos::MDRangePolicy<
-            Kokkos::resilience::ResilientReplicate<Kokkos::Cuda>,
+            Kokkos::resilience::ResilientReplicate<ExecutionSpace>,
             Kokkos::Rank<2>>;
 
-        using range_policy = Kokkos::RangePolicy<>;
-        using mdrange_policy = Kokkos::MDRangePolicy<Kokkos::Rank<2>>;
+        using mdrange_policy =
+            Kokkos::MDRangePolicy<ExecutionSpace, Kokkos::Rank<2>>;
 
         Kokkos::parallel_for(
-            "copy_g", mdrange_policy({0u, 0u}, {nbLines, M}),
+            "copy_g", mdrange_policy(inst, {0u, 0u}, {nbLines, M}),
             KOKKOS_LAMBDA(std::size_t i, std::size_t j) {
                 h((i * M) + j) = g((i * M) + j);
             });
 
+        /* MPI reads g and writes the halo rows of h */
+        inst.fence();
+
         double* g_raw = g.data();
         double* h_raw = h.data();
 
@@ -76,6 +76,28 @@ namespace heatdis {
                 WORKTAG, MPI_COMM_WORLD, &req2[1]);
         }
 
+        auto compute = KOKKOS_LAMBDA(std::size_t i, std::size_t j)
+        {
+            g((i * M) + j) = 0.25 *
+                (h(((i - 1) * M) + j) + h(((i + 1) * M) + j) +
+                    h((i * M) + j - 1) + h((i * M) + j + 1));
+
+            return fabs(g((i * M) + j) - h((i * M) + j));
+        };
+
+        /* perform the computation on the interior rows, they do not depend on
+     * the halo rows. The replicated kernel blocks until it is validated and
+     * makes no MPI calls, so the posted requests only progress meanwhile if
+     * the MPI library progresses them asynchronously */
+        std::size_t const last_row = nbLines - 2;
+        if (last_row > 2)
+        {
+            Kokkos::parallel_for("compute_interior",
+                resilient_mdrange_policy(
+                    replicate_inst, {2u, 0u}, {last_row, M}),
+                compute);
+        }
+
         /* this should probably include ALL ranks
      * (currently excludes leftmost and rightmost)
      */
@@ -88,22 +110,17 @@ namespace heatdis {
             MPI_Waitall(2, req2, status2);
         }
 
-        /* perform the computation */
-        Kokkos::parallel_for(
-            "compute",
-            resilient_mdrange_policy(
-                replicate_inst, {1u, 0u}, {nbLines - 1, M}),
-            KOKKOS_LAMBDA(std::size_t i, std::size_t j) {
-                g((i * M) + j) = 0.25 *
-                    (h(((i - 1) * M) + j) + h(((i + 1) * M) + j) +
-                        h((i * M) + j - 1) + h((i * M) + j + 1));
-                if (localerror[0] < fabs(g((i * M) + j) - h((i * M) + j)))
-                {
-                    localerror[0] = fabs(g((i * M) + j) - h((i * M) + j));
-                }
-
-                return fabs(g((i * M) + j) - h((i * M) + j));
-            });
+        /* perform the computation on the rows next to the halo */
+        Kokkos::parallel_for("compute_boundary_first",
+            resilient_mdrange_policy(replicate_inst, {1u, 0u}, {2u, M}),
+            compute);
+        if (last_row > 1)
+        {
+            Kokkos::parallel_for("compute_boundary_last",
+                resilient_mdrange_policy(
+                    replicate_inst, {last_row, 0u}, {last_row + 1, M}),
+                compute);
+        }
 
         /* perform computation on right-most rank */
         if (rank == (numprocs - 1))
@@ -116,9 +133,57 @@ namespace heatdis {
                     return g(((nbLines - 1) * M) + j);
                 });
         }
+    }
 
-        Kokkos::deep_copy(localerror_host, localerror);
-
-        return localerror_host[0];
+    /* largest change of the last step over the computed rows, in a single
+     * sweep. The shadow, the negated largest change, is accumulated
+     * separately so that a corrupted accumulation is detected */
+    template <typename ExecutionSpace>
+    Kokkos::resilience::mpi::contribution localError(
+        ExecutionSpace const& inst, std::size_t M, std::size_t nbLines,
+        view_type<ExecutionSpace> g, view_type<ExecutionSpace> h)
+    {
+        using mdrange_policy =
+            Kokkos::MDRangePolicy<ExecutionSpace, Kokkos::Rank<2>>;
+        using error_type = typename Kokkos::MinMax<double>::value_type;
+
+        error_type error;
+        Kokkos::parallel_reduce("local_error",
+            mdrange_policy(inst, {1u, 0u}, {nbLines - 1, M}),
+            KOKKOS_LAMBDA(std::size_t i, std::size_t j, error_type& local) {
+                double const change = fabs(g((i * M) + j) - h((i * M) + j));
+                local.max_val = fmax(local.max_val, change);
+                local.min_val = fmin(local.min_val, -change);
+            },
+            Kokkos::MinMax<double>(error));
+
+        return {error.max_val, error.min_val};
     }
+
+#define HEATDIS_INSTANTIATE(SPACE)                                             \
+    template void initData<SPACE>(SPACE const&, std::size_t, std::size_t,      \
+        std::size_t, view_type<SPACE>);                                        \
+    template void doWork<SPACE>(SPACE const&, std::size_t, std::size_t,        \
+        std::size_t, std::size_t, view_type<SPACE>, view_type<SPACE>);         \
+    template Kokkos::resilience::mpi::contribution localError<SPACE>(          \
+        SPACE const&, std::size_t, std::size_t, view_type<SPACE>,              \
+        view_type<SPACE>);
+
+#if defined(KOKKOS_ENABLE_SERIAL)
+    HEATDIS_INSTANTIATE(Kokkos::Serial)
+#endif
+#if defined(KOKKOS_ENABLE_OPENMP)
+    HEATDIS_INSTANTIATE(Kokkos::OpenMP)
+#endif
+#if defined(KOKKOS_ENABLE_THREADS)
+    HEATDIS_INSTANTIATE(Kokkos::Threads)
+#endif
+#if defined(KOKKOS_ENABLE_CUDA)
+    HEATDIS_INSTANTIATE(Kokkos::Cuda)
+#endif
+#if defined(KOKKOS_ENABLE_HIP)
+    HEATDIS_INSTANTIATE(Kokkos::Experimental::HIP)
+#endif
+
+#undef HEATDIS_INSTANTIATE
 }    // namespace heatdis
@@ -4,8 +4,12 @@
 
 #include <mpi.h>
 
+#include <string>
+
 #include "heatdis.hpp"
 
+#include <resilient_spaces/mpi/allreduce.hpp>
+
 /* Added to test restart */
 #include <signal.h>
 #include <sys/types.h>
@@ -18,10 +22,110 @@ using namespace heatdis;
     originally developed within the FTI project: github.com/leobago/fti
 */
 
+template <typename ExecutionSpace>
+int run(std::size_t rank, std::size_t nbProcs, std::size_t mem_size,
+    std::size_t nsteps, double precision, int strong)
+{
+    std::size_t nbLines, M;
+    double wtime, memSize, globalerror = 1;
+
+    ExecutionSpace inst{};
+
+    if (!strong)
+    {
+        /* weak scaling */
+        M = sqrt((double) (mem_size * 1024.0 * 1024.0 * nbProcs) /
+            (2 * sizeof(double)));    // two matrices needed
+        nbLines = (M / nbProcs) + 3;
+    }
+    else
+    {
+        /* strong scaling */
+        M = sqrt((double) (mem_size * 1024.0 * 1024.0 * nbProcs) /
+            (2 * sizeof(double) * nbProcs));    // two matrices needed
+        nbLines = (M / nbProcs) + 3;
+    }
+
+    view_type<ExecutionSpace> h_view("h", M * nbLines);
+    view_type<ExecutionSpace> g_view("g", M * nbLines);
+
+    initData(inst, nbLines, M, rank, g_view);
+
+    memSize = M * nbLines * 2 * sizeof(double) / (1024 * 1024);
+
+    if (rank == 0)
+        if (!strong)
+        {
+            printf("Local data size is %lu x %lu = %f MB (%lu).\n", M, nbLines,
+                memSize, mem_size);
+        }
+        else
+        {
+            printf("Local data size is %lu x %lu = %f MB (%lu).\n", M, nbLines,
+                memSize, mem_size / nbProcs);
+        }
+    if (rank == 0)
+        printf("Execution space : %s (concurrency %d)\n", inst.name(),
+            (int) inst.concurrency());
+    if (rank == 0)
+        printf("Target precision : %f \n", precision);
+    if (rank == 0)
+        printf("Maximum number of iterations : %lu \n", nsteps);
+
+    // Protects the convergence check against corrupted local errors, which
+    // are reduced with their shadow in one sweep per attempt, and against
+    // corruption in transit. Per-step scalars should be added to the same
+    // batch.
+    Kokkos::resilience::mpi::ResilientAllreduce reduction(MPI_COMM_WORLD);
+
+    inst.fence();
+    wtime = MPI_Wtime();
+    std::size_t i = 0;
+
+    while (i < nsteps)
+    {
+        doWork(inst, nbProcs, rank, M, nbLines, g_view, h_view);
+
+        if (((i % ITER_OUT) == 0) && (rank == 0))
+        {
+            printf("Step : %lu, error = %f\n", i, globalerror);
+        }
+        if ((i % REDUCED) == 0)
+        {
+            reduction.clear();
+            std::size_t const error_index = reduction.add(
+                [&] {
+                    return localError(inst, M, nbLines, g_view, h_view);
+                },
+                Kokkos::resilience::mpi::reduce_op::max);
+            reduction.execute();
+            globalerror = reduction.result(error_index);
+        }
+
+        if (globalerror < precision)
+        {
+            printf("PRECISION ERROR\n");
+            break;
+        }
+        i++;
+    }
+    inst.fence();
+
+    double const elapsed = MPI_Wtime() - wtime;
+    if (rank == 0)
+    {
+        printf("Execution finished in %lf seconds.\n", elapsed);
+        printf("Time per step : %lf seconds (%lu steps).\n",
+            i == 0 ? 0. : elapsed / i, i);
+        printf("Collective retries : %lu\n", reduction.retries());
+    }
+
+    return 0;
+}
+
 int main(int argc, char* argv[])
 {
-    std::size_t rank, nbProcs, nbLines, M;
-    double wtime, memSize, localerror, globalerror = 1;
+    std::size_t rank, nbProcs;
 
     namespace bpo = boost::program_options;
     bpo::options_description desc("Heatdis");
@@ -35,6 +139,9 @@ int main(int argc, char* argv[])
     // desc.add_options()("config", bpo::value<std::string>());
     desc.add_options()(
         "scale", bpo::value<std::string>()->default_value("weak"));
+    desc.add_options()("backend",
+        bpo::value<std::string>()->default_value("default"),
+        "Execution space: default, serial, openmp, threads, cuda or hip");
 
     bpo::variables_map vm;
 
@@ -45,12 +152,14 @@ int main(int argc, char* argv[])
     std::size_t nsteps = vm["nsteps"].as<std::size_t>();
     const auto precision = vm["precision"].as<double>();
 
-    int strong = 0, str_ret;
+    int strong = 0;
 
     std::string scale = vm["scale"].as<std::string>();
     if (scale == "strong")
         strong = 1;
 
+    std::string const backend = vm["backend"].as<std::string>();
+
     MPI_Init(&argc, &argv);
     int mpi_nbProcs, mpi_rank;
     MPI_Comm_size(MPI_COMM_WORLD, &mpi_nbProcs);
@@ -66,84 +175,44 @@ int main(int argc, char* argv[])
         exit(3);
     }
 
+    int result = -1;
+
     Kokkos::initialize(argc, argv);
     {
-        if (!strong)
-        {
-            /* weak scaling */
-            M = sqrt((double) (mem_size * 1024.0 * 1024.0 * nbProcs) /
-                (2 * sizeof(double)));    // two matrices needed
-            nbLines = (M / nbProcs) + 3;
-        }
-        else
-        {
-            /* strong scaling */
-            M = sqrt((double) (mem_size * 1024.0 * 1024.0 * nbProcs) /
-                (2 * sizeof(double) * nbProcs));    // two matrices needed
-            nbLines = (M / nbProcs) + 3;
-        }
-
-        Kokkos::View<double*> h_view("h", M * nbLines);
-        Kokkos::View<double*> g_view("g", M * nbLines);
-
-        initData(nbLines, M, rank, g_view);
-
-        memSize = M * nbLines * 2 * sizeof(double) / (1024 * 1024);
-
-        // printf("nbProcs: %d\n", nbProcs);
-        // printf("size of double: %d\n", sizeof(double));
-
-        if (rank == 0)
-            if (!strong)
-            {
-                printf("Local data size is %lu x %lu = %f MB (%lu).\n", M,
-                    nbLines, memSize, mem_size);
-            }
-            else
-            {
-                printf("Local data size is %lu x %lu = %f MB (%lu).\n", M,
-                    nbLines, memSize, mem_size / nbProcs);
-            }
-        if (rank == 0)
-            printf("Target precision : %f \n", precision);
-        if (rank == 0)
-            printf("Maximum number of iterations : %lu \n", nsteps);
-
-        wtime = MPI_Wtime();
-        int i = 0;
-        int v = i;
-        printf("i: %d --- v: %d\n", i, v);
-        if (i < 0)
-        {
-            i = 0;
-        }
-
-        while (i < nsteps)
-        {
-            localerror = doWork(nbProcs, rank, M, nbLines, g_view, h_view);
-
-            if (((i % ITER_OUT) == 0) && (rank == 0))
-            {
-                printf("Step : %d, error = %f\n", i, globalerror);
-            }
-            if ((i % REDUCED) == 0)
-            {
-                MPI_Allreduce(&localerror, &globalerror, 1, MPI_DOUBLE, MPI_MAX,
-                    MPI_COMM_WORLD);
-            }
-
-            if (globalerror < precision)
-            {
-                printf("PRECISION ERROR\n");
-                break;
-            }
-            i++;
-        }
-        if (rank == 0)
-            printf("Execution finished in %lf seconds.\n", MPI_Wtime() - wtime);
+        if (backend == "default")
+            result = run<Kokkos::DefaultExecutionSpace>(
+                rank, nbProcs, mem_size, nsteps, precision, strong);
+#if defined(KOKKOS_ENABLE_SERIAL)
+        else if (backend == "serial")
+            result = run<Kokkos::Serial>(
+                rank, nbProcs, mem_size, nsteps, precision, strong);
+#endif
+#if defined(KOKKOS_ENABLE_OPENMP)
+        else if (backend == "openmp")
+            result = run<Kokkos::OpenMP>(
+                rank, nbProcs, mem_size, nsteps, precision, strong);
+#endif
+#if defined(KOKKOS_ENABLE_THREADS)
+        else if (backend == "threads")
+            result = run<Kokkos::Threads>(
+                rank, nbProcs, mem_size, nsteps, precision, strong);
+#endif
+#if defined(KOKKOS_ENABLE_CUDA)
+        else if (backend == "cuda")
+            result = run<Kokkos::Cuda>(
+                rank, nbProcs, mem_size, nsteps, precision, strong);
+#endif
+#if defined(KOKKOS_ENABLE_HIP)
+        else if (backend == "hip")
+            result = run<Kokkos::Experimental::HIP>(
+                rank, nbProcs, mem_size, nsteps, precision, strong);
+#endif
+
+        if (result < 0 && rank == 0)
+            printf("Backend '%s' is not enabled in Kokkos.\n", backend.c_str());
     }
     Kokkos::finalize();
 
     MPI_Finalize();
-    return 0;
+    return result < 0 ? 2 : result;
 }
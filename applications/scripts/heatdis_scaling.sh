@@ -0,0 +1,107 @@
+#!/usr/bin/env bash
+#  Copyright (c) 2021 Nikunj Gupta
+#
+#  SPDX-License-Identifier: BSL-1.0
+#  Distributed under the Boost Software License, Version 1.0. (See accompanying
+#  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+# CPU scaling study of the heatdis stencil: runs the non-resilient and the
+# resilient applications on the host backends with local MPI ranks and reports
+# the time per step and the overhead of resilience.
+#
+# usage: heatdis_scaling.sh <build directory> [options]
+#
+#   --backends "serial openmp threads"   host backends to run
+#   --ranks "1 2 4"                      MPI ranks per run
+#   --threads "1 2 4 8"                  threads per rank (openmp/threads)
+#   --size 100                           problem size per rank (MB)
+#   --nsteps 600                         timesteps
+#   --scale weak|strong
+#   --mpirun "mpirun --oversubscribe"    MPI launcher
+
+set -euo pipefail
+
+if [[ $# -lt 1 ]]; then
+    sed -n '8,20p' "$0" | sed 's/^# \{0,1\}//'
+    exit 1
+fi
+
+build_dir=$1
+shift
+
+backends="serial openmp threads"
+ranks="1 2 4"
+threads="1 2 4 8"
+size=100
+nsteps=600
+scale=weak
+mpirun=${MPIRUN:-mpirun}
+
+while [[ $# -gt 0 ]]; do
+    case $1 in
+        --backends) backends=$2; shift 2 ;;
+        --ranks) ranks=$2; shift 2 ;;
+        --threads) threads=$2; shift 2 ;;
+        --size) size=$2; shift 2 ;;
+        --nsteps) nsteps=$2; shift 2 ;;
+        --scale) scale=$2; shift 2 ;;
+        --mpirun) mpirun=$2; shift 2 ;;
+        *) echo "unknown option: $1" >&2; exit 1 ;;
+    esac
+done
+
+# The project places all executables in its runtime output directory
+baseline=$build_dir/bin/stencil
+resilient=$build_dir/bin/stencil_resilient
+
+for exe in "$baseline" "$resilient"; do
+    if [[ ! -x $exe ]]; then
+        echo "missing executable: $exe" >&2
+        exit 1
+    fi
+done
+
+# Prints the time per step of one run, or "n/a" if the backend is disabled.
+time_per_step() {
+    local exe=$1 backend=$2 np=$3 nt=$4
+    local output
+
+    # Thread counts go through the environment, the applications reject
+    # unknown command line options.
+    if ! output=$(KOKKOS_NUM_THREADS=$nt OMP_NUM_THREADS=$nt \
+        OMP_PROC_BIND=spread OMP_PLACES=threads $mpirun -np "$np" "$exe" --backend "$backend" \
+        --size "$size" --nsteps "$nsteps" --scale "$scale" 2>&1); then
+        echo "n/a"
+        return
+    fi
+
+    awk '/^Time per step/ { print $5 }' <<< "$output"
+}
+
+printf "%-8s %6s %8s %14s %14s %10s\n" \
+    backend ranks threads "baseline (s)" "resilient (s)" overhead
+
+for backend in $backends; do
+    thread_counts=$threads
+    if [[ $backend == serial ]]; then
+        thread_counts=1
+    fi
+
+    for np in $ranks; do
+        for nt in $thread_counts; do
+            base=$(time_per_step "$baseline" "$backend" "$np" "$nt")
+            res=$(time_per_step "$resilient" "$backend" "$np" "$nt")
+
+            if [[ $base == n/a || $res == n/a || -z $base || -z $res ]]; then
+                printf "%-8s %6s %8s %14s %14s %10s\n" \
+                    "$backend" "$np" "$nt" "${base:-n/a}" "${res:-n/a}" n/a
+                continue
+            fi
+
+            overhead=$(awk -v b="$base" -v r="$res" \
+                'BEGIN { printf "%.1f%%", (b > 0) ? 100 * (r - b) / b : 0 }')
+            printf "%-8s %6s %8s %14s %14s %10s\n" \
+                "$backend" "$np" "$nt" "$base" "$res" "$overhead"
+        done
+    done
+done
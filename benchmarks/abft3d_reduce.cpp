@@ -0,0 +1,154 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <Kokkos_Core.hpp>
+
+#include <resilient_spaces/resilient_spaces.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <cstdio>
+#include <vector>
+
+// Replayed checksum reduction of the ABFT3D stencil, flattened to a range
+// over i with j and k loops in the functor against a tiled MDRangePolicy
+// over (i, j, k). Both are validated with the same result validator.
+
+using view_type = Kokkos::View<double***>;
+using replay_space =
+    Kokkos::resilience::ResilientReplay<Kokkos::DefaultExecutionSpace,
+        Kokkos::resilience::validators::finite>;
+
+KOKKOS_FUNCTION double stencil6p(double self, double xm, double xp, double ym,
+    double yp, double zm, double zp, double cfl)
+{
+    return (1.0 - 6.0 * cfl) * self + cfl * (xm + xp + ym + yp + zm + zp);
+}
+
+template <typename Function>
+double time_per_point(Function const& function, int n, std::size_t repeat)
+{
+    // Warm up
+    function();
+    Kokkos::fence();
+
+    Kokkos::Timer timer;
+    for (std::size_t r = 0; r != repeat; ++r)
+        function();
+    Kokkos::fence();
+
+    return timer.seconds() * 1e9 / (double(n) * n * n * repeat);
+}
+
+int main(int argc, char* argv[])
+{
+    double const cfl = 0.1;
+
+    namespace bpo = boost::program_options;
+    bpo::options_description desc("ABFT3D checksum reduction");
+
+    desc.add_options()("size",
+        bpo::value<std::vector<int>>()
+            ->multitoken()
+            ->default_value(
+                std::vector<int>{98, 128, 192, 256}, "98 128 192 256"),
+        "Interior points per dimension");
+    desc.add_options()("tile", bpo::value<int>()->default_value(0),
+        "Tile extent per dimension, 0 lets the backend choose");
+    desc.add_options()(
+        "repeat", bpo::value<std::size_t>()->default_value(10u), "Repeats");
+
+    bpo::variables_map vm;
+
+    // Setup commandline arguments
+    bpo::store(bpo::parse_command_line(argc, argv, desc), vm);
+    bpo::notify(vm);
+
+    std::vector<int> const sizes = vm["size"].as<std::vector<int>>();
+    int const tile = vm["tile"].as<int>();
+    std::size_t const repeat = vm["repeat"].as<std::size_t>();
+
+    Kokkos::initialize(argc, argv);
+    {
+        replay_space const space(3,
+            Kokkos::resilience::validators::finite{},
+            Kokkos::DefaultExecutionSpace{});
+
+        std::printf("%6s %14s %14s %9s\n", "size", "flat ns/point",
+            "tiled ns/point", "speedup");
+
+        for (int const n : sizes)
+        {
+            view_type stencil_old("stencil_old", n + 2, n + 2, n + 2);
+            view_type stencil_new("stencil_new", n + 2, n + 2, n + 2);
+
+            Kokkos::parallel_for("init",
+                Kokkos::MDRangePolicy<Kokkos::Rank<3>>(
+                    {0, 0, 0}, {n + 2, n + 2, n + 2}),
+                KOKKOS_LAMBDA(int i, int j, int k) {
+                    stencil_old(i, j, k) = 1.0 + 1e-3 * (i + j + k);
+                });
+
+            double flat_sum = 0.;
+            double const flat = time_per_point(
+                [&] {
+                    Kokkos::parallel_reduce("flat",
+                        Kokkos::RangePolicy<replay_space>(space, 1, n + 1),
+                        KOKKOS_LAMBDA(int i, double& chk) {
+                            for (int j = 1; j <= n; ++j)
+                            {
+                                for (int k = 1; k <= n; ++k)
+                                {
+                                    stencil_new(i, j, k) =
+                                        stencil6p(stencil_old(i, j, k),
+                                            stencil_old(i - 1, j, k),
+                                            stencil_old(i + 1, j, k),
+                                            stencil_old(i, j - 1, k),
+                                            stencil_old(i, j + 1, k),
+                                            stencil_old(i, j, k - 1),
+                                            stencil_old(i, j, k + 1), cfl);
+                                    chk += stencil_new(i, j, k);
+                                }
+                            }
+                        },
+                        flat_sum);
+                },
+                n, repeat);
+
+            double tiled_sum = 0.;
+            double const tiled = time_per_point(
+                [&] {
+                    Kokkos::parallel_reduce("tiled",
+                        Kokkos::MDRangePolicy<replay_space, Kokkos::Rank<3>>(
+                            space, {1, 1, 1}, {n + 1, n + 1, n + 1},
+                            {tile, tile, tile}),
+                        KOKKOS_LAMBDA(int i, int j, int k, double& chk) {
+                            stencil_new(i, j, k) =
+                                stencil6p(stencil_old(i, j, k),
+                                    stencil_old(i - 1, j, k),
+                                    stencil_old(i + 1, j, k),
+                                    stencil_old(i, j - 1, k),
+                                    stencil_old(i, j + 1, k),
+                                    stencil_old(i, j, k - 1),
+                                    stencil_old(i, j, k + 1), cfl);
+                            chk += stencil_new(i, j, k);
+                        },
+                        tiled_sum);
+                },
+                n, repeat);
+
+            std::printf("%6d %14.3f %14.3f %8.2fx %s\n", n, flat, tiled,
+                flat / tiled,
+                Kokkos::abs(flat_sum - tiled_sum) <=
+                        1e-9 * Kokkos::abs(flat_sum) ?
+                    "" :
+                    "(checksums differ)");
+        }
+    }
+    Kokkos::finalize();
+
+    return 0;
+}
@@ -0,0 +1,206 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <Kokkos_Core.hpp>
+
+#include <resilient_spaces/checkpoint/checkpoint.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#define PI 3.1415926535897932384
+
+// Compression ratio and throughput of compressed checkpoints on the fields of
+// the heatdis and ABFT3D applications, after a few timesteps of evolution.
+
+template <typename ViewType>
+void report(std::string const& name, ViewType const& field,
+    std::string const& path, std::size_t block_values)
+{
+    namespace ckpt = Kokkos::resilience::checkpoint;
+    namespace fpc = Kokkos::resilience::checkpoint::fpc;
+
+    auto host =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, field);
+    double const* data = host.data();
+    std::size_t const n = host.span();
+    std::size_t const blocks = (n + block_values - 1) / block_values;
+    double const gigabytes = double(n * sizeof(double)) / 1e9;
+
+    // In-memory codec throughput across the host threads
+    std::size_t const bound = fpc::compressed_bound<double>(block_values);
+    std::vector<unsigned char> buffer(blocks * bound);
+    std::vector<std::size_t> sizes(blocks);
+    std::vector<double> decoded(n);
+
+    Kokkos::Timer timer;
+    Kokkos::parallel_for("compress",
+        Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>(0, blocks),
+        [&](std::size_t b) {
+            std::size_t const begin = b * block_values;
+            sizes[b] = fpc::compress(data + begin,
+                std::min(block_values, n - begin),
+                buffer.data() + b * bound);
+        });
+    Kokkos::DefaultHostExecutionSpace().fence();
+    double const compress_time = timer.seconds();
+
+    timer.reset();
+    Kokkos::parallel_for("decompress",
+        Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>(0, blocks),
+        [&](std::size_t b) {
+            std::size_t const begin = b * block_values;
+            fpc::decompress(
+                buffer.data() + b * bound,
+                sizes[b], std::min(block_values, n - begin),
+                decoded.data() + begin);
+        });
+    Kokkos::DefaultHostExecutionSpace().fence();
+    double const decompress_time = timer.seconds();
+
+    // End-to-end checkpoint to local disk
+    timer.reset();
+    auto stats = ckpt::write(path, field, block_values);
+    double const write_time = timer.seconds();
+
+    timer.reset();
+    ckpt::read(path, field);
+    double const read_time = timer.seconds();
+
+    std::remove(path.c_str());
+
+    std::printf("%-8s %10.2f MB %10.2f MB ratio %6.2f | codec %7.2f / %7.2f "
+                "GB/s | disk %7.2f / %7.2f GB/s\n",
+        name.c_str(), double(stats.raw_bytes) / 1e6,
+        double(stats.compressed_bytes) / 1e6, stats.ratio(),
+        gigabytes / compress_time, gigabytes / decompress_time,
+        gigabytes / write_time, gigabytes / read_time);
+}
+
+Kokkos::View<double*> heatdis_field(std::size_t M, std::size_t nbLines,
+    std::size_t steps)
+{
+    Kokkos::View<double*> g("g", M * nbLines);
+    Kokkos::View<double*> h("h", M * nbLines);
+
+    // Same initial condition as rank 0 of heatdis
+    Kokkos::parallel_for(
+        "init_rank0", Kokkos::RangePolicy<>(M / 10, (9 * M) / 10),
+        KOKKOS_LAMBDA(std::size_t i) { g(i) = 100; });
+
+    for (std::size_t s = 0; s != steps; ++s)
+    {
+        Kokkos::deep_copy(h, g);
+        Kokkos::parallel_for(
+            "compute",
+            Kokkos::MDRangePolicy<Kokkos::Rank<2>>(
+                {1u, 1u}, {nbLines - 1, M - 1}),
+            KOKKOS_LAMBDA(std::size_t i, std::size_t j) {
+                g((i * M) + j) = 0.25 *
+                    (h(((i - 1) * M) + j) + h(((i + 1) * M) + j) +
+                        h((i * M) + j - 1) + h((i * M) + j + 1));
+            });
+    }
+    Kokkos::fence();
+
+    return g;
+}
+
+Kokkos::View<double***> abft3d_field(int size, std::size_t steps)
+{
+    double const cfl = 0.1;
+
+    Kokkos::View<double***> stencil_old(
+        "data1", size + 2, size + 2, size + 2);
+    Kokkos::View<double***> stencil_new(
+        "data2", size + 2, size + 2, size + 2);
+
+    Kokkos::parallel_for(
+        "init",
+        Kokkos::MDRangePolicy<Kokkos::Rank<3>>(
+            {0, 0, 0}, {size + 2, size + 2, size + 2}),
+        KOKKOS_LAMBDA(int i, int j, int k) {
+            stencil_old(i, j, k) =
+                std::sin(1.0 * PI * (double) i / (double) (size + 1));
+            stencil_new(i, j, k) = stencil_old(i, j, k);
+        });
+
+    for (std::size_t s = 0; s != steps; ++s)
+    {
+        Kokkos::parallel_for(
+            "stencil_op",
+            Kokkos::MDRangePolicy<Kokkos::Rank<3>>(
+                {1, 1, 1}, {size + 1, size + 1, size + 1}),
+            KOKKOS_LAMBDA(int i, int j, int k) {
+                stencil_new(i, j, k) =
+                    (1.0 - 6.0 * cfl) * stencil_old(i, j, k) +
+                    cfl *
+                        (stencil_old(i - 1, j, k) + stencil_old(i + 1, j, k) +
+                            stencil_old(i, j - 1, k) +
+                            stencil_old(i, j + 1, k) +
+                            stencil_old(i, j, k - 1) +
+                            stencil_old(i, j, k + 1));
+            });
+        std::swap(stencil_old, stencil_new);
+    }
+    Kokkos::fence();
+
+    return stencil_old;
+}
+
+int main(int argc, char* argv[])
+{
+    namespace bpo = boost::program_options;
+    bpo::options_description desc("Checkpoint compression");
+
+    desc.add_options()("size", bpo::value<std::size_t>()->default_value(100u),
+        "heatdis problem size (MB)");
+    desc.add_options()(
+        "xsize", bpo::value<int>()->default_value(98), "ABFT3D dimension");
+    desc.add_options()("nsteps", bpo::value<std::size_t>()->default_value(10u),
+        "Timesteps before checkpointing");
+    desc.add_options()("block",
+        bpo::value<std::size_t>()->default_value(
+            Kokkos::resilience::checkpoint::default_block_values),
+        "Values per compressed block");
+    desc.add_options()("path",
+        bpo::value<std::string>()->default_value("krs_checkpoint.bin"),
+        "Checkpoint file on local disk");
+
+    bpo::variables_map vm;
+
+    // Setup commandline arguments
+    bpo::store(bpo::parse_command_line(argc, argv, desc), vm);
+    bpo::notify(vm);
+
+    std::size_t const mem_size = vm["size"].as<std::size_t>();
+    int const xsize = vm["xsize"].as<int>();
+    std::size_t const nsteps = vm["nsteps"].as<std::size_t>();
+    std::size_t const block_values = vm["block"].as<std::size_t>();
+    std::string const path = vm["path"].as<std::string>();
+
+    Kokkos::initialize(argc, argv);
+    {
+        std::size_t const M =
+            std::sqrt((double) (mem_size * 1024.0 * 1024.0) /
+                (2 * sizeof(double)));
+        std::size_t const nbLines = M + 3;
+
+        std::printf("%-8s %13s %13s %12s | %28s | %27s\n", "field", "raw",
+            "compressed", "", "compress / decompress", "write / read");
+
+        report("heatdis", heatdis_field(M, nbLines, nsteps), path,
+            block_values);
+        report("ABFT3D", abft3d_field(xsize, nsteps), path, block_values);
+    }
+    Kokkos::finalize();
+
+    return 0;
+}
@@ -0,0 +1,168 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <Kokkos_Core.hpp>
+
+#include <resilient_spaces/resilient_spaces.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <cstdio>
+#include <string>
+
+// STREAM copy, scale, add and triad on plain Views and on ECC protected
+// Views of the host execution space. Bandwidth counts the values moved,
+// not the check bytes, so the difference is the cost of protection.
+
+using space = Kokkos::DefaultHostExecutionSpace;
+using policy = Kokkos::RangePolicy<space>;
+using plain_view = Kokkos::View<double*, space::memory_space>;
+using ecc_view =
+    Kokkos::resilience::ecc::EccView<double, space::memory_space>;
+
+template <typename Function>
+double bandwidth(Function const& function, std::size_t bytes,
+    std::size_t repeat)
+{
+    // Warm up
+    function();
+    space().fence();
+
+    Kokkos::Timer timer;
+    for (std::size_t r = 0; r != repeat; ++r)
+        function();
+    space().fence();
+
+    return double(bytes * repeat) / timer.seconds() * 1e-9;
+}
+
+void report(std::string const& name, double plain, double ecc)
+{
+    std::printf("%-8s %10.2f GB/s %10.2f GB/s %8.1f %%\n", name.c_str(),
+        plain, ecc, 100. * (plain - ecc) / plain);
+}
+
+int main(int argc, char* argv[])
+{
+    namespace bpo = boost::program_options;
+    bpo::options_description desc("ECC protected STREAM");
+
+    desc.add_options()("size",
+        bpo::value<std::size_t>()->default_value(1u << 25), "Elements");
+    desc.add_options()(
+        "repeat", bpo::value<std::size_t>()->default_value(20u), "Repeats");
+
+    bpo::variables_map vm;
+
+    // Setup commandline arguments
+    bpo::store(bpo::parse_command_line(argc, argv, desc), vm);
+    bpo::notify(vm);
+
+    std::size_t const n = vm["size"].as<std::size_t>();
+    std::size_t const repeat = vm["repeat"].as<std::size_t>();
+
+    Kokkos::initialize(argc, argv);
+    {
+        double const s = 3.0;
+        std::size_t const bytes = n * sizeof(double);
+
+        plain_view a("a", n);
+        plain_view b("b", n);
+        plain_view c("c", n);
+
+        ecc_view ea("a", n);
+        ecc_view eb("b", n);
+        ecc_view ec("c", n);
+
+        Kokkos::parallel_for(
+            "init", policy(0, n), KOKKOS_LAMBDA(int i) {
+                a(i) = 1.0;
+                b(i) = 2.0;
+                c(i) = 0.0;
+                ea.store(i, 1.0);
+                eb.store(i, 2.0);
+                ec.store(i, 0.0);
+            });
+
+        std::printf("%-8s %15s %15s %10s\n", "kernel", "plain", "ecc",
+            "overhead");
+
+        report("copy",
+            bandwidth(
+                [&] {
+                    Kokkos::parallel_for(
+                        "copy", policy(0, n),
+                        KOKKOS_LAMBDA(int i) { c(i) = a(i); });
+                },
+                2 * bytes, repeat),
+            bandwidth(
+                [&] {
+                    Kokkos::parallel_for(
+                        "ecc_copy", policy(0, n),
+                        KOKKOS_LAMBDA(int i) { ec.store(i, ea.load(i)); });
+                },
+                2 * bytes, repeat));
+
+        report("scale",
+            bandwidth(
+                [&] {
+                    Kokkos::parallel_for(
+                        "scale", policy(0, n),
+                        KOKKOS_LAMBDA(int i) { b(i) = s * c(i); });
+                },
+                2 * bytes, repeat),
+            bandwidth(
+                [&] {
+                    Kokkos::parallel_for(
+                        "ecc_scale", policy(0, n), KOKKOS_LAMBDA(int i) {
+                            eb.store(i, s * ec.load(i));
+                        });
+                },
+                2 * bytes, repeat));
+
+        report("add",
+            bandwidth(
+                [&] {
+                    Kokkos::parallel_for(
+                        "add", policy(0, n),
+                        KOKKOS_LAMBDA(int i) { c(i) = a(i) + b(i); });
+                },
+                3 * bytes, repeat),
+            bandwidth(
+                [&] {
+                    Kokkos::parallel_for(
+                        "ecc_add", policy(0, n), KOKKOS_LAMBDA(int i) {
+                            ec.store(i, ea.load(i) + eb.load(i));
+                        });
+                },
+                3 * bytes, repeat));
+
+        report("triad",
+            bandwidth(
+                [&] {
+                    Kokkos::parallel_for(
+                        "triad", policy(0, n),
+                        KOKKOS_LAMBDA(int i) { a(i) = b(i) + s * c(i); });
+                },
+                3 * bytes, repeat),
+            bandwidth(
+                [&] {
+                    Kokkos::parallel_for(
+                        "ecc_triad", policy(0, n), KOKKOS_LAMBDA(int i) {
+                            ea.store(i, eb.load(i) + s * ec.load(i));
+                        });
+                },
+                3 * bytes, repeat));
+
+        auto const errors = ea.errors();
+        std::printf("\ncorrected %llu, uncorrectable %llu\n",
+            (unsigned long long) errors.corrected,
+            (unsigned long long) errors.uncorrectable);
+    }
+    Kokkos::finalize();
+
+    return 0;
+}
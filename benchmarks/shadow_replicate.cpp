@@ -0,0 +1,138 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <Kokkos_Core.hpp>
+
+#include <resilient_spaces/resilient_spaces.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <cstdio>
+#include <string>
+#include <type_traits>
+
+// Cost of checking a heatdis-like 5-point stencil with a float shadow
+// replica against a full double replica and the unchecked kernel.
+
+using view_type = Kokkos::View<double**>;
+using space = Kokkos::DefaultExecutionSpace;
+
+template <typename Real>
+struct heat
+{
+    template <typename Other>
+    using rebind = heat<Other>;
+
+    heat(view_type g_, view_type h_)
+      : g(g_)
+      , h(h_)
+    {
+    }
+
+    template <typename Other>
+    explicit heat(heat<Other> const& other)
+      : g(other.g)
+      , h(other.h)
+    {
+    }
+
+    KOKKOS_FUNCTION Real operator()(int i, int j) const
+    {
+        Real const result = Real(0.25) *
+            (Real(h(i - 1, j)) + Real(h(i + 1, j)) + Real(h(i, j - 1)) +
+                Real(h(i, j + 1)));
+
+        // The shadow only computes
+        if constexpr (std::is_same<Real, double>::value)
+            g(i, j) = result;
+        return result;
+    }
+
+    view_type g;
+    view_type h;
+};
+
+template <typename Function>
+double time_per_point(Function const& function, int n, std::size_t repeat)
+{
+    // Warm up
+    function();
+    Kokkos::fence();
+
+    Kokkos::Timer timer;
+    for (std::size_t r = 0; r != repeat; ++r)
+        function();
+    Kokkos::fence();
+
+    return timer.seconds() * 1e9 / (double(n) * n * repeat);
+}
+
+template <typename Space>
+double sweep(heat<double> const& kernel, Space const& inst, int n,
+    std::size_t repeat)
+{
+    using policy = Kokkos::MDRangePolicy<Space, Kokkos::Rank<2>>;
+
+    return time_per_point(
+        [&] {
+            Kokkos::parallel_for(
+                "heat", policy(inst, {1, 1}, {n + 1, n + 1}), kernel);
+        },
+        n, repeat);
+}
+
+int main(int argc, char* argv[])
+{
+    namespace bpo = boost::program_options;
+    bpo::options_description desc("Reduced precision shadow replicas");
+
+    desc.add_options()("size", bpo::value<int>()->default_value(2048),
+        "Interior points per dimension");
+    desc.add_options()(
+        "repeat", bpo::value<std::size_t>()->default_value(20u), "Repeats");
+
+    bpo::variables_map vm;
+
+    // Setup commandline arguments
+    bpo::store(bpo::parse_command_line(argc, argv, desc), vm);
+    bpo::notify(vm);
+
+    int const n = vm["size"].as<int>();
+    std::size_t const repeat = vm["repeat"].as<std::size_t>();
+
+    Kokkos::initialize(argc, argv);
+    {
+        view_type g("g", n + 2, n + 2);
+        view_type h("h", n + 2, n + 2);
+
+        Kokkos::parallel_for("init",
+            Kokkos::MDRangePolicy<Kokkos::Rank<2>>({0, 0}, {n + 2, n + 2}),
+            KOKKOS_LAMBDA(int i, int j) { h(i, j) = 100. * i * j / n / n; });
+
+        heat<double> const kernel(g, h);
+
+        double const plain = sweep(kernel, space{}, n, repeat);
+        double const replicate = sweep(kernel,
+            Kokkos::resilience::ResilientReplicate<space>(), n, repeat);
+
+        // Inputs are at most 100
+        using shadow_space =
+            Kokkos::resilience::ResilientShadowReplicate<space>;
+        double const shadow = sweep(kernel,
+            shadow_space(shadow_space::relative_bound(),
+                shadow_space::absolute_bound(100.)),
+            n, repeat);
+
+        std::printf("%-16s %10.3f ns/point\n", "plain", plain);
+        std::printf("%-16s %10.3f ns/point %+8.1f %%\n", "replicate",
+            replicate, 100. * (replicate - plain) / plain);
+        std::printf("%-16s %10.3f ns/point %+8.1f %%\n", "float shadow",
+            shadow, 100. * (shadow - plain) / plain);
+    }
+    Kokkos::finalize();
+
+    return 0;
+}
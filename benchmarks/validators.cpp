@@ -0,0 +1,165 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <Kokkos_Core.hpp>
+
+#include <resilient_spaces/resilient_spaces.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <cstdio>
+#include <string>
+
+// Per-element cost of the ready-made validators, measured on a streaming
+// kernel (one load, one store per element). Per-index validators are
+// timed under ResilientReplay against the same kernel on the plain
+// execution space, block validators on their own.
+
+using view_type = Kokkos::View<double*>;
+
+namespace validators = Kokkos::resilience::validators;
+
+struct scale
+{
+    KOKKOS_FUNCTION double operator()(int i) const
+    {
+        data(i) = 1.0001 * previous(i);
+        return data(i);
+    }
+
+    view_type data;
+    view_type previous;
+};
+
+struct accept
+{
+    template <typename... Args>
+    KOKKOS_FUNCTION bool operator()(Args const&...) const
+    {
+        return true;
+    }
+};
+
+template <typename Function>
+double time_per_element(
+    Function const& function, std::size_t n, std::size_t repeat)
+{
+    // Warm up
+    function();
+    Kokkos::fence();
+
+    Kokkos::Timer timer;
+    for (std::size_t r = 0; r != repeat; ++r)
+        function();
+    Kokkos::fence();
+
+    return timer.seconds() * 1e9 / double(n * repeat);
+}
+
+template <typename Validator>
+void report_index(std::string const& name, Validator const& validator,
+    scale const& kernel, std::size_t n, std::size_t repeat, double baseline)
+{
+    using replay_space =
+        Kokkos::resilience::ResilientReplay<Kokkos::DefaultExecutionSpace,
+            Validator>;
+
+    replay_space space(3, validator, Kokkos::DefaultExecutionSpace{});
+    double const t = time_per_element(
+        [&] {
+            Kokkos::parallel_for(
+                Kokkos::RangePolicy<replay_space>(space, 0, n), kernel);
+        },
+        n, repeat);
+
+    std::printf("%-18s %10.3f ns/element %+10.3f ns/element\n", name.c_str(),
+        t, t - baseline);
+}
+
+template <typename Validator>
+void report_block(std::string const& name, Validator const& validator,
+    std::size_t n, std::size_t repeat)
+{
+    double const t = time_per_element([&] { validator(); }, n, repeat);
+
+    std::printf("%-18s %10.3f ns/element\n", name.c_str(), t);
+}
+
+int main(int argc, char* argv[])
+{
+    namespace bpo = boost::program_options;
+    bpo::options_description desc("Validator cost");
+
+    desc.add_options()("size",
+        bpo::value<std::size_t>()->default_value(1u << 24), "Elements");
+    desc.add_options()(
+        "repeat", bpo::value<std::size_t>()->default_value(20u), "Repeats");
+
+    bpo::variables_map vm;
+
+    // Setup commandline arguments
+    bpo::store(bpo::parse_command_line(argc, argv, desc), vm);
+    bpo::notify(vm);
+
+    std::size_t const n = vm["size"].as<std::size_t>();
+    std::size_t const repeat = vm["repeat"].as<std::size_t>();
+
+    Kokkos::initialize(argc, argv);
+    {
+        view_type data("data", n);
+        view_type previous("previous", n);
+        view_type reference("reference", n);
+
+        Kokkos::parallel_for(
+            "init", Kokkos::RangePolicy<>(0, n), KOKKOS_LAMBDA(int i) {
+                previous(i) = 1.0 + i;
+                reference(i) = 1.0001 * previous(i);
+            });
+
+        scale const kernel{data, previous};
+
+        double const baseline = time_per_element(
+            [&] {
+                Kokkos::parallel_for(Kokkos::RangePolicy<>(0, n), kernel);
+            },
+            n, repeat);
+
+        std::printf("%-18s %10.3f ns/element\n", "plain kernel", baseline);
+        std::printf("\nper-index validators (replay, overhead)\n");
+
+        validators::finite const finite{};
+        validators::bounds<double> const bounds{0., 2. * n};
+        validators::monotonic<view_type> const monotonic{previous};
+        validators::relative_residual<view_type> const residual{
+            reference, 1e-12};
+
+        report_index("accept", accept{}, kernel, n, repeat, baseline);
+        report_index("finite", finite, kernel, n, repeat, baseline);
+        report_index("bounds", bounds, kernel, n, repeat, baseline);
+        report_index("monotonic", monotonic, kernel, n, repeat, baseline);
+        report_index(
+            "relative_residual", residual, kernel, n, repeat, baseline);
+        report_index("fused (all four)",
+            validators::all(finite, bounds, monotonic, residual), kernel, n,
+            repeat, baseline);
+
+        std::printf("\nblock validators\n");
+
+        report_block(
+            "finite", validators::make_block(data, finite), n, repeat);
+        report_block("fused (all four)",
+            validators::make_block(data,
+                validators::all(finite, bounds, monotonic, residual)),
+            n, repeat);
+
+        validators::conservation<view_type> mass(data, 0.);
+        mass.set_expected(mass.sum());
+        report_block("conservation", mass, n, repeat);
+    }
+    Kokkos::finalize();
+
+    return 0;
+}
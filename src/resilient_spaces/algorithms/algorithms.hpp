@@ -0,0 +1,294 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <Kokkos_Core.hpp>
+#include <Kokkos_Sort.hpp>
+#include <Kokkos_StdAlgorithms.hpp>
+
+#include <resilient_spaces/replay/replay_execution_space.hpp>
+#include <resilient_spaces/replicate/replicate_execution_space.hpp>
+#include <resilient_spaces/util/hash.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+// Resilient versions of common Kokkos std-algorithms and Kokkos::sort on
+// rank-1 Views.
+//
+// Instead of replicating the algorithm, every call is followed by a single
+// algorithm-specific verification pass on the base execution space and the
+// algorithm is rerun if the check fails:
+//  - transform: every output is compared bitwise against the recomputed
+//    operation, fused in one reduction without stores.
+//  - reduce: a shadow sum of the negated values is accumulated in the same
+//    sweep, an intact result is its exact negation. Only the sum of
+//    arithmetic values is supported.
+//  - copy_if: count and order-independent checksum of the selected inputs
+//    must match the output, and every output must satisfy the predicate.
+//  - sort: the output must be sorted and have the same multiset checksum as
+//    the input, the input is backed up for reruns.
+//
+// ResilientReplay spaces rerun up to replays() times, ResilientReplicate
+// and ResilientReplicateTiled spaces up to three times. Validators of the
+// spaces are not used.
+//
+// Not included by resilient_spaces.hpp, as it pulls in the std-algorithms
+// and sort headers.
+namespace Kokkos { namespace resilience { namespace algorithms {
+
+    namespace detail {
+
+        template <typename ExecutionSpace, typename Validator>
+        std::uint64_t attempts(
+            ResilientReplay<ExecutionSpace, Validator> const& space)
+        {
+            return space.replays();
+        }
+
+        template <typename ExecutionSpace>
+        std::uint64_t attempts(ResilientReplicate<ExecutionSpace> const&)
+        {
+            return 3;
+        }
+
+        template <typename ExecutionSpace>
+        std::uint64_t attempts(
+            ResilientReplicateTiled<ExecutionSpace> const&)
+        {
+            return 3;
+        }
+
+        template <typename Space>
+        typename Space::base_execution_space const& base(Space const& space)
+        {
+            return space;
+        }
+
+        using util::fingerprint;
+
+        template <typename T>
+        KOKKOS_INLINE_FUNCTION bool bitwise_equal(T const& a, T const& b)
+        {
+            auto const lhs = reinterpret_cast<unsigned char const*>(&a);
+            auto const rhs = reinterpret_cast<unsigned char const*>(&b);
+
+            bool equal = true;
+            for (std::size_t k = 0; k != sizeof(T); ++k)
+                equal = equal && lhs[k] == rhs[k];
+            return equal;
+        }
+
+        // Sum of values and of their negations. Negation is exact and
+        // rounding is symmetric, so intact sums of the same values in the
+        // same order satisfy value == -shadow bit for bit.
+        template <typename T>
+        struct dual_sum
+        {
+            T value{};
+            T shadow{};
+
+            KOKKOS_INLINE_FUNCTION dual_sum& operator+=(dual_sum const& other)
+            {
+                value += other.value;
+                shadow += other.shadow;
+                return *this;
+            }
+
+            bool intact() const noexcept
+            {
+                if (value != value)
+                    return shadow != shadow;
+
+                return value == T(-shadow);
+            }
+        };
+
+        // Order-independent checksum and count of a set of values
+        struct checksum
+        {
+            std::uint64_t sum = 0;
+            std::uint64_t count = 0;
+
+            KOKKOS_INLINE_FUNCTION checksum& operator+=(checksum const& other)
+            {
+                sum += other.sum;
+                count += other.count;
+                return *this;
+            }
+        };
+
+        [[noreturn]] inline void out_of_replays()
+        {
+            throw std::runtime_error("Program ran out of replay options.");
+        }
+
+    }    // namespace detail
+
+    template <typename Space, typename InView, typename OutView,
+        typename UnaryOp>
+    void transform(Space const& space, InView const& in, OutView const& out,
+        UnaryOp const& op)
+    {
+        using base_execution_space = typename Space::base_execution_space;
+        using value_type = typename OutView::non_const_value_type;
+
+        if (in.data() == out.data())
+            throw std::runtime_error(
+                "Resilient transform requires distinct input and output.");
+
+        auto const& base = detail::base(space);
+        std::size_t const n = in.extent(0);
+
+        for (std::uint64_t a = 0; a != detail::attempts(space); ++a)
+        {
+            Kokkos::Experimental::transform(
+                "krs_transform", base, in, out, op);
+
+            std::size_t failures = 0;
+            Kokkos::parallel_reduce("krs_transform_check",
+                Kokkos::RangePolicy<base_execution_space>(base, 0, n),
+                KOKKOS_LAMBDA(std::size_t i, std::size_t & count) {
+                    value_type const expected = op(in(i));
+                    count += !detail::bitwise_equal(out(i), expected);
+                },
+                failures);
+
+            if (failures == 0)
+                return;
+        }
+
+        detail::out_of_replays();
+    }
+
+    template <typename Space, typename ViewType, typename T>
+    T reduce(Space const& space, ViewType const& view, T init)
+    {
+        static_assert(std::is_arithmetic<T>::value,
+            "Resilient reduce sums arithmetic values.");
+
+        using base_execution_space = typename Space::base_execution_space;
+
+        auto const& base = detail::base(space);
+        std::size_t const n = view.extent(0);
+
+        for (std::uint64_t a = 0; a != detail::attempts(space); ++a)
+        {
+            detail::dual_sum<T> sum{init, T(-init)};
+            detail::dual_sum<T> values;
+            Kokkos::parallel_reduce("krs_reduce",
+                Kokkos::RangePolicy<base_execution_space>(base, 0, n),
+                KOKKOS_LAMBDA(std::size_t i, detail::dual_sum<T> & partial) {
+                    T const value = view(i);
+                    partial.value += value;
+                    partial.shadow += T(-value);
+                },
+                values);
+            sum += values;
+
+            if (sum.intact())
+                return sum.value;
+        }
+
+        detail::out_of_replays();
+    }
+
+    // Returns the number of copied values.
+    template <typename Space, typename InView, typename OutView,
+        typename Predicate>
+    std::size_t copy_if(Space const& space, InView const& in,
+        OutView const& out, Predicate const& pred)
+    {
+        using base_execution_space = typename Space::base_execution_space;
+        using policy = Kokkos::RangePolicy<base_execution_space>;
+
+        auto const& base = detail::base(space);
+        std::size_t const n = in.extent(0);
+
+        for (std::uint64_t a = 0; a != detail::attempts(space); ++a)
+        {
+            auto const last = Kokkos::Experimental::copy_if(
+                "krs_copy_if", base, in, out, pred);
+            std::size_t const count = last - Kokkos::Experimental::begin(out);
+
+            detail::checksum selected;
+            Kokkos::parallel_reduce("krs_copy_if_check", policy(base, 0, n),
+                KOKKOS_LAMBDA(std::size_t i, detail::checksum & sum) {
+                    bool const keep = pred(in(i));
+                    sum.sum += keep ? detail::fingerprint(in(i)) : 0;
+                    sum.count += keep;
+                },
+                selected);
+
+            // count holds the values not satisfying the predicate
+            detail::checksum copied;
+            Kokkos::parallel_reduce("krs_copy_if_check",
+                policy(base, 0, count),
+                KOKKOS_LAMBDA(std::size_t i, detail::checksum & sum) {
+                    sum.sum += detail::fingerprint(out(i));
+                    sum.count += !pred(out(i));
+                },
+                copied);
+
+            if (selected.count == count && selected.sum == copied.sum &&
+                copied.count == 0)
+                return count;
+        }
+
+        detail::out_of_replays();
+    }
+
+    template <typename Space, typename ViewType>
+    void sort(Space const& space, ViewType const& view)
+    {
+        using base_execution_space = typename Space::base_execution_space;
+        using policy = Kokkos::RangePolicy<base_execution_space>;
+
+        auto const& base = detail::base(space);
+        std::size_t const n = view.extent(0);
+
+        // Backup for reruns, fused with the input checksum
+        Kokkos::View<typename ViewType::non_const_value_type*,
+            typename ViewType::memory_space>
+            backup(Kokkos::view_alloc(
+                       Kokkos::WithoutInitializing, "krs_sort_backup"),
+                n);
+
+        detail::checksum input;
+        Kokkos::parallel_reduce("krs_sort_backup", policy(base, 0, n),
+            KOKKOS_LAMBDA(std::size_t i, detail::checksum & sum) {
+                backup(i) = view(i);
+                sum.sum += detail::fingerprint(view(i));
+            },
+            input);
+
+        for (std::uint64_t a = 0; a != detail::attempts(space); ++a)
+        {
+            if (a != 0)
+                Kokkos::deep_copy(base, view, backup);
+
+            Kokkos::sort(base, view);
+
+            // count holds the unsorted neighbours
+            detail::checksum output;
+            Kokkos::parallel_reduce("krs_sort_check", policy(base, 0, n),
+                KOKKOS_LAMBDA(std::size_t i, detail::checksum & sum) {
+                    sum.sum += detail::fingerprint(view(i));
+                    sum.count += i + 1 != n && view(i + 1) < view(i);
+                },
+                output);
+
+            if (output.sum == input.sum && output.count == 0)
+                return;
+        }
+
+        detail::out_of_replays();
+    }
+
+}}}    // namespace Kokkos::resilience::algorithms
@@ -0,0 +1,431 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <Kokkos_Core.hpp>
+
+#include <resilient_spaces/checkpoint/fpc.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Compressed View checkpoints.
+//
+// A checkpoint file is a stream of independently compressed blocks:
+//
+//   header  : magic | version | value size | reserved | values per block
+//   blocks  : compressed blocks, appended as soon as they are ready
+//   index   : {offset, bytes, values} per block
+//   trailer : total values | number of blocks | index offset | magic | reserved
+//
+// The index is written last so blocks can be streamed to disk without knowing
+// their compressed sizes up front. Readers locate it through the fixed-size
+// trailer, which also makes it cheap to restore a single block.
+namespace Kokkos { namespace resilience { namespace checkpoint {
+
+    constexpr std::uint32_t file_magic = 0x4353524b;    // "KRSC"
+    constexpr std::uint32_t file_version = 1;
+    constexpr std::size_t default_block_values = std::size_t(1) << 16;
+
+    struct statistics
+    {
+        std::size_t raw_bytes = 0;
+        std::size_t compressed_bytes = 0;
+        std::size_t blocks = 0;
+
+        double ratio() const noexcept
+        {
+            return compressed_bytes == 0 ?
+                0. :
+                double(raw_bytes) / double(compressed_bytes);
+        }
+    };
+
+    namespace detail {
+
+        struct file_header
+        {
+            std::uint32_t magic;
+            std::uint32_t version;
+            std::uint32_t value_size;
+            std::uint32_t reserved;
+            std::uint64_t block_values;
+        };
+
+        struct block_entry
+        {
+            std::uint64_t offset;
+            std::uint64_t bytes;
+            std::uint64_t values;
+        };
+
+        struct file_trailer
+        {
+            std::uint64_t values;
+            std::uint64_t blocks;
+            std::uint64_t index_offset;
+            std::uint32_t magic;
+            std::uint32_t reserved;
+        };
+
+        struct file_layout
+        {
+            file_header header;
+            file_trailer trailer;
+            std::vector<block_entry> index;
+        };
+
+        template <typename T>
+        void write_raw(std::ofstream& os, T const& value)
+        {
+            os.write(reinterpret_cast<char const*>(&value), sizeof(T));
+        }
+
+        template <typename T>
+        void read_raw(std::ifstream& is, T& value)
+        {
+            is.read(reinterpret_cast<char*>(&value), sizeof(T));
+        }
+
+        inline std::size_t compression_batch()
+        {
+            std::size_t const concurrency =
+                Kokkos::DefaultHostExecutionSpace().concurrency();
+            return std::max<std::size_t>(2 * concurrency, 1);
+        }
+
+        template <typename T>
+        statistics write_values(std::string const& path, T const* data,
+            std::size_t n, std::size_t block_values)
+        {
+            if (block_values == 0)
+                throw std::runtime_error("Checkpoint block size must be > 0.");
+
+            std::ofstream os(path, std::ios::binary | std::ios::trunc);
+            if (!os)
+                throw std::runtime_error(
+                    "Unable to open checkpoint file: " + path);
+
+            file_header header{
+                file_magic, file_version, sizeof(T), 0, block_values};
+            write_raw(os, header);
+
+            std::size_t const blocks = (n + block_values - 1) / block_values;
+            std::size_t const batch = compression_batch();
+
+            std::vector<std::vector<unsigned char>> buffers(
+                std::min(batch, blocks));
+            for (auto& buffer : buffers)
+                buffer.resize(fpc::compressed_bound<T>(block_values));
+            std::vector<std::size_t> sizes(buffers.size());
+
+            std::vector<block_entry> index;
+            index.reserve(blocks);
+
+            statistics stats;
+            stats.raw_bytes = n * sizeof(T);
+            stats.blocks = blocks;
+
+            // Compress a batch of blocks across the host threads, then stream
+            // it out while keeping the memory footprint bounded.
+            for (std::size_t first = 0; first < blocks; first += batch)
+            {
+                std::size_t const count = std::min(batch, blocks - first);
+
+                Kokkos::parallel_for("krs_checkpoint_compress",
+                    Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>(
+                        0, count),
+                    [&](std::size_t b) {
+                        std::size_t const begin = (first + b) * block_values;
+                        std::size_t const values =
+                            std::min(block_values, n - begin);
+                        sizes[b] = fpc::compress(
+                            data + begin, values, buffers[b].data());
+                    });
+                Kokkos::DefaultHostExecutionSpace().fence();
+
+                for (std::size_t b = 0; b != count; ++b)
+                {
+                    std::size_t const begin = (first + b) * block_values;
+                    index.push_back(
+                        block_entry{std::uint64_t(os.tellp()), sizes[b],
+                            std::min(block_values, n - begin)});
+                    os.write(reinterpret_cast<char const*>(buffers[b].data()),
+                        std::streamsize(sizes[b]));
+                    stats.compressed_bytes += sizes[b];
+                }
+            }
+
+            file_trailer trailer{
+                n, blocks, std::uint64_t(os.tellp()), file_magic, 0};
+            for (auto const& entry : index)
+                write_raw(os, entry);
+            write_raw(os, trailer);
+
+            if (!os)
+                throw std::runtime_error(
+                    "Failed to write checkpoint file: " + path);
+
+            return stats;
+        }
+
+        // The trailer must describe an index that ends right before it,
+        // checked before the index is allocated.
+        inline bool valid_trailer(file_header const& header,
+            file_trailer const& trailer, std::uint64_t file_bytes)
+        {
+            std::uint64_t const index_end =
+                file_bytes - sizeof(file_trailer);
+
+            if (header.block_values == 0 ||
+                trailer.index_offset < sizeof(file_header) ||
+                trailer.index_offset > index_end ||
+                (index_end - trailer.index_offset) % sizeof(block_entry) != 0)
+                return false;
+
+            std::uint64_t const blocks =
+                (index_end - trailer.index_offset) / sizeof(block_entry);
+            std::uint64_t const expected =
+                trailer.values / header.block_values +
+                (trailer.values % header.block_values != 0);
+
+            return trailer.blocks == blocks && trailer.blocks == expected;
+        }
+
+        // Blocks are stored in order between the header and the index, and
+        // each holds block_values values except the last one.
+        inline bool valid_index(file_layout const& layout)
+        {
+            std::uint64_t const block_values = layout.header.block_values;
+            std::uint64_t end = sizeof(file_header);
+
+            for (std::size_t b = 0; b != layout.index.size(); ++b)
+            {
+                block_entry const& entry = layout.index[b];
+                std::uint64_t const remaining =
+                    layout.trailer.values - b * block_values;
+
+                if (entry.offset < end ||
+                    entry.offset > layout.trailer.index_offset ||
+                    entry.bytes > layout.trailer.index_offset - entry.offset ||
+                    entry.values != std::min(block_values, remaining))
+                    return false;
+
+                end = entry.offset + entry.bytes;
+            }
+            return true;
+        }
+
+        inline file_layout read_layout(
+            std::ifstream& is, std::string const& path)
+        {
+            file_layout layout;
+
+            is.seekg(0, std::ios::end);
+            std::streamoff const file_bytes = is.tellg();
+            is.seekg(0);
+
+            if (!is ||
+                file_bytes <
+                    std::streamoff(sizeof(file_header) + sizeof(file_trailer)))
+                throw std::runtime_error("Not a checkpoint file: " + path);
+
+            read_raw(is, layout.header);
+            is.seekg(-std::streamoff(sizeof(file_trailer)), std::ios::end);
+            read_raw(is, layout.trailer);
+
+            if (!is || layout.header.magic != file_magic ||
+                layout.trailer.magic != file_magic)
+                throw std::runtime_error("Not a checkpoint file: " + path);
+
+            if (layout.header.version != file_version)
+                throw std::runtime_error(
+                    "Unsupported checkpoint version: " + path);
+
+            if (!valid_trailer(
+                    layout.header, layout.trailer, std::uint64_t(file_bytes)))
+                throw std::runtime_error("Corrupted checkpoint index: " + path);
+
+            layout.index.resize(layout.trailer.blocks);
+            is.seekg(std::streamoff(layout.trailer.index_offset));
+            for (auto& entry : layout.index)
+                read_raw(is, entry);
+
+            if (!is || !valid_index(layout))
+                throw std::runtime_error("Corrupted checkpoint index: " + path);
+
+            return layout;
+        }
+
+        template <typename T>
+        file_layout open_values(
+            std::ifstream& is, std::string const& path, std::size_t n)
+        {
+            if (!is)
+                throw std::runtime_error(
+                    "Unable to open checkpoint file: " + path);
+
+            file_layout layout = read_layout(is, path);
+
+            if (layout.header.value_size != sizeof(T))
+                throw std::runtime_error(
+                    "Checkpoint value type does not match the View: " + path);
+
+            if (layout.trailer.values != n)
+                throw std::runtime_error(
+                    "Checkpoint extent does not match the View: " + path);
+
+            for (auto const& entry : layout.index)
+            {
+                if (entry.bytes > fpc::compressed_bound<T>(entry.values))
+                    throw std::runtime_error(
+                        "Corrupted checkpoint index: " + path);
+            }
+
+            return layout;
+        }
+
+        template <typename T>
+        void read_values(std::string const& path, T* data, std::size_t n)
+        {
+            std::ifstream is(path, std::ios::binary);
+            file_layout const layout = open_values<T>(is, path, n);
+
+            std::size_t const begin = sizeof(file_header);
+            std::vector<unsigned char> payload(
+                layout.trailer.index_offset - begin);
+            is.seekg(std::streamoff(begin));
+            is.read(reinterpret_cast<char*>(payload.data()),
+                std::streamsize(payload.size()));
+
+            if (!is)
+                throw std::runtime_error("Truncated checkpoint file: " + path);
+
+            std::size_t const block_values = layout.header.block_values;
+
+            Kokkos::parallel_for("krs_checkpoint_decompress",
+                Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>(
+                    0, layout.index.size()),
+                [&](std::size_t b) {
+                    auto const& entry = layout.index[b];
+                    fpc::decompress(payload.data() + (entry.offset - begin),
+                        entry.bytes, entry.values, data + b * block_values);
+                });
+            Kokkos::DefaultHostExecutionSpace().fence();
+        }
+
+        // Returns the offset (in values) of the restored block.
+        template <typename T>
+        std::size_t read_block_values(std::string const& path,
+            std::size_t n, std::size_t block, std::vector<T>& values)
+        {
+            std::ifstream is(path, std::ios::binary);
+            file_layout const layout = open_values<T>(is, path, n);
+
+            if (block >= layout.index.size())
+                throw std::out_of_range("Checkpoint block out of range.");
+
+            auto const& entry = layout.index[block];
+
+            std::vector<unsigned char> payload(entry.bytes);
+            is.seekg(std::streamoff(entry.offset));
+            is.read(reinterpret_cast<char*>(payload.data()),
+                std::streamsize(payload.size()));
+
+            if (!is)
+                throw std::runtime_error("Truncated checkpoint file: " + path);
+
+            values.resize(entry.values);
+            fpc::decompress(
+                payload.data(), payload.size(), entry.values, values.data());
+
+            return block * layout.header.block_values;
+        }
+
+        template <typename ViewType>
+        void check_view(ViewType const& view)
+        {
+            using value_type = typename ViewType::non_const_value_type;
+
+            static_assert(std::is_same<value_type, double>::value ||
+                    std::is_same<value_type, float>::value,
+                "Compressed checkpoints support float and double Views only.");
+
+            if (!view.span_is_contiguous())
+                throw std::runtime_error(
+                    "Checkpointing requires a contiguous View.");
+        }
+
+    }    // namespace detail
+
+    // Writes a compressed checkpoint of the View to path.
+    template <typename ViewType>
+    statistics write(std::string const& path, ViewType const& view,
+        std::size_t block_values = default_block_values)
+    {
+        detail::check_view(view);
+
+        auto host =
+            Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, view);
+
+        return detail::write_values(
+            path, host.data(), host.span(), block_values);
+    }
+
+    // Restores the complete View from the checkpoint at path.
+    template <typename ViewType>
+    void read(std::string const& path, ViewType const& view)
+    {
+        detail::check_view(view);
+
+        auto host = Kokkos::create_mirror_view(Kokkos::HostSpace{}, view);
+
+        detail::read_values(path, host.data(), host.span());
+        Kokkos::deep_copy(view, host);
+    }
+
+    // Restores a single block of the View from the checkpoint at path,
+    // leaving all other values untouched.
+    template <typename ViewType>
+    void read_block(
+        std::string const& path, ViewType const& view, std::size_t block)
+    {
+        using value_type = typename ViewType::non_const_value_type;
+        using memory_space = typename ViewType::memory_space;
+        using unmanaged = Kokkos::MemoryTraits<Kokkos::Unmanaged>;
+
+        detail::check_view(view);
+
+        std::vector<value_type> values;
+        std::size_t const offset =
+            detail::read_block_values(path, view.span(), block, values);
+
+        Kokkos::View<value_type*, memory_space, unmanaged> dst(
+            view.data() + offset, values.size());
+        Kokkos::View<value_type*, Kokkos::HostSpace, unmanaged> src(
+            values.data(), values.size());
+
+        Kokkos::deep_copy(dst, src);
+    }
+
+    // Returns the number of independently restorable blocks in a checkpoint.
+    inline std::size_t block_count(std::string const& path)
+    {
+        std::ifstream is(path, std::ios::binary);
+        if (!is)
+            throw std::runtime_error("Unable to open checkpoint file: " + path);
+
+        return detail::read_layout(is, path).index.size();
+    }
+
+}}}    // namespace Kokkos::resilience::checkpoint
@@ -0,0 +1,174 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+// Lossless floating point codec in the spirit of FPC (Burtscher and
+// Ratanaworabhan) and Gorilla. Every value is predicted twice, once from the
+// previous value and once by extrapolating the stride of the two previous
+// values. The prediction with the most leading zero bytes in its XOR residual
+// wins. A 4-bit header (selector bit + 3-bit leading zero byte count) is
+// emitted per value, followed by the non-zero residual bytes.
+//
+// A compressed block is laid out as [headers: ceil(n / 2) bytes][residuals].
+namespace Kokkos { namespace resilience { namespace checkpoint { namespace fpc {
+
+    template <typename T>
+    struct codec_traits;
+
+    template <>
+    struct codec_traits<double>
+    {
+        using bits_type = std::uint64_t;
+
+        // 3 bits cannot hold 0..8, FPC drops 4 and encodes it as 3.
+        static constexpr unsigned encode_count(unsigned lzb) noexcept
+        {
+            return lzb == 4 ? 3 : (lzb > 4 ? lzb - 1 : lzb);
+        }
+
+        static constexpr unsigned decode_count(unsigned code) noexcept
+        {
+            return code > 3 ? code + 1 : code;
+        }
+    };
+
+    template <>
+    struct codec_traits<float>
+    {
+        using bits_type = std::uint32_t;
+
+        static constexpr unsigned encode_count(unsigned lzb) noexcept
+        {
+            return lzb;
+        }
+
+        static constexpr unsigned decode_count(unsigned code) noexcept
+        {
+            return code;
+        }
+    };
+
+    namespace detail {
+
+        inline unsigned leading_zero_bytes(std::uint64_t x) noexcept
+        {
+            return x == 0 ? 8u : unsigned(__builtin_clzll(x)) / 8u;
+        }
+
+        inline unsigned leading_zero_bytes(std::uint32_t x) noexcept
+        {
+            return x == 0 ? 4u : unsigned(__builtin_clz(x)) / 8u;
+        }
+
+    }    // namespace detail
+
+    // Upper bound of the compressed size of n values of type T.
+    template <typename T>
+    constexpr std::size_t compressed_bound(std::size_t n) noexcept
+    {
+        return (n + 1) / 2 + n * sizeof(T);
+    }
+
+    // Compresses n values into out, which must hold at least
+    // compressed_bound<T>(n) bytes. Returns the number of bytes written.
+    template <typename T>
+    std::size_t compress(T const* in, std::size_t n, unsigned char* out)
+    {
+        using traits = codec_traits<T>;
+        using bits_type = typename traits::bits_type;
+
+        unsigned char* headers = out;
+        unsigned char* residuals = out + (n + 1) / 2;
+        std::memset(headers, 0, (n + 1) / 2);
+
+        bits_type last = 0;
+        bits_type last2 = 0;
+
+        for (std::size_t i = 0; i != n; ++i)
+        {
+            bits_type value;
+            std::memcpy(&value, in + i, sizeof(T));
+
+            bits_type const stride_pred = last + (last - last2);
+            bits_type const xor_last = value ^ last;
+            bits_type const xor_stride = value ^ stride_pred;
+
+            unsigned lzb_last = detail::leading_zero_bytes(xor_last);
+            unsigned lzb_stride = detail::leading_zero_bytes(xor_stride);
+
+            unsigned selector = lzb_stride > lzb_last ? 1u : 0u;
+            bits_type residual = selector ? xor_stride : xor_last;
+            unsigned code = traits::encode_count(
+                selector ? lzb_stride : lzb_last);
+            unsigned lzb = traits::decode_count(code);
+
+            headers[i / 2] |= static_cast<unsigned char>(
+                ((selector << 3) | code) << ((i % 2) * 4));
+
+            for (unsigned b = 0; b != sizeof(T) - lzb; ++b)
+            {
+                *residuals++ =
+                    static_cast<unsigned char>(residual >> (8 * b));
+            }
+
+            last2 = last;
+            last = value;
+        }
+
+        return static_cast<std::size_t>(residuals - out);
+    }
+
+    // Decompresses n values from a block of the given size that was
+    // produced by compress.
+    template <typename T>
+    void decompress(unsigned char const* in, std::size_t bytes,
+        std::size_t n, T* out)
+    {
+        using traits = codec_traits<T>;
+        using bits_type = typename traits::bits_type;
+
+        unsigned char const* headers = in;
+        unsigned char const* residuals = in + (n + 1) / 2;
+        unsigned char const* end = in + bytes;
+
+        if (residuals > end)
+            throw std::runtime_error("Truncated compressed block.");
+
+        bits_type last = 0;
+        bits_type last2 = 0;
+
+        for (std::size_t i = 0; i != n; ++i)
+        {
+            unsigned header = (headers[i / 2] >> ((i % 2) * 4)) & 0xfu;
+            unsigned lzb = traits::decode_count(header & 0x7u);
+
+            if (residuals + (sizeof(T) - lzb) > end)
+                throw std::runtime_error("Truncated compressed block.");
+
+            bits_type residual = 0;
+            for (unsigned b = 0; b != sizeof(T) - lzb; ++b)
+            {
+                residual |= bits_type(*residuals++) << (8 * b);
+            }
+
+            bits_type const pred =
+                (header & 0x8u) ? bits_type(last + (last - last2)) : last;
+            bits_type const value = residual ^ pred;
+
+            std::memcpy(out + i, &value, sizeof(T));
+
+            last2 = last;
+            last = value;
+        }
+    }
+
+}}}}    // namespace Kokkos::resilience::checkpoint::fpc
@@ -0,0 +1,270 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <Kokkos_Core.hpp>
+
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace Kokkos { namespace resilience {
+
+    enum class Strategy
+    {
+        none,
+        replay,
+        replicate
+    };
+
+    namespace util {
+
+        struct StrategyEntry
+        {
+            Strategy strategy = Strategy::replicate;
+            std::uint64_t count = 3;
+        };
+
+        inline std::string trim(std::string const& s)
+        {
+            auto const first = s.find_first_not_of(" \t\r\n");
+            if (first == std::string::npos)
+                return {};
+            return s.substr(first, s.find_last_not_of(" \t\r\n") - first + 1);
+        }
+
+        // Parses "strategy" or "strategy:count"
+        inline StrategyEntry parse_strategy(std::string const& value)
+        {
+            auto const colon = value.find(':');
+            std::string const name = trim(value.substr(0, colon));
+
+            StrategyEntry entry;
+            if (name == "none")
+                entry = {Strategy::none, 1};
+            else if (name == "replay")
+                entry = {Strategy::replay, 3};
+            else if (name == "replicate")
+                entry = {Strategy::replicate, 3};
+            else
+                throw std::runtime_error(
+                    "Unknown resilience strategy '" + name + "'.");
+
+            if (colon != std::string::npos)
+            {
+                if (entry.strategy == Strategy::none)
+                    throw std::runtime_error(
+                        "Resilience strategy 'none' takes no count.");
+
+                std::string const count = trim(value.substr(colon + 1));
+                if (count.empty() ||
+                    count.find_first_not_of("0123456789") != std::string::npos)
+                    throw std::runtime_error(
+                        "Invalid resilience count '" + count + "'.");
+
+                entry.count = std::stoull(count);
+                if (entry.count == 0)
+                    throw std::runtime_error(
+                        "Resilience count must be positive.");
+            }
+
+            return entry;
+        }
+
+        // Adds the "label=strategy[:count]" entries of a specification,
+        // separated by commas, semicolons or newlines. Text after '#' up to
+        // the end of the line is ignored.
+        inline void parse_strategies(std::string const& spec,
+            std::map<std::string, StrategyEntry>& entries)
+        {
+            std::istringstream lines(spec);
+            std::string line;
+            while (std::getline(lines, line))
+            {
+                line = line.substr(0, line.find('#'));
+
+                std::size_t begin = 0;
+                while (begin <= line.size())
+                {
+                    std::size_t end = line.find_first_of(",;", begin);
+                    if (end == std::string::npos)
+                        end = line.size();
+
+                    std::string const item =
+                        trim(line.substr(begin, end - begin));
+                    begin = end + 1;
+
+                    if (item.empty())
+                        continue;
+
+                    auto const equal = item.find('=');
+                    if (equal == std::string::npos)
+                        throw std::runtime_error(
+                            "Expected label=strategy, got '" + item + "'.");
+
+                    entries[trim(item.substr(0, equal))] =
+                        parse_strategy(item.substr(equal + 1));
+                }
+            }
+        }
+
+        // Strategies per kernel label, read once from the file named by
+        // KRS_RESILIENCE_FILE and then from KRS_RESILIENCE, which takes
+        // precedence.
+        inline std::map<std::string, StrategyEntry> const& strategies()
+        {
+            static std::map<std::string, StrategyEntry> const entries = [] {
+                std::map<std::string, StrategyEntry> entries;
+
+                if (char const* path = std::getenv("KRS_RESILIENCE_FILE"))
+                {
+                    std::ifstream file(path);
+                    if (!file)
+                        throw std::runtime_error(
+                            "Cannot open resilience configuration '" +
+                            std::string(path) + "'.");
+
+                    std::stringstream content;
+                    content << file.rdbuf();
+                    parse_strategies(content.str(), entries);
+                }
+
+                if (char const* spec = std::getenv("KRS_RESILIENCE"))
+                    parse_strategies(spec, entries);
+
+                return entries;
+            }();
+            return entries;
+        }
+
+        // Labels without an entry use the "*" entry, or replicate with
+        // three replicas if there is none.
+        inline StrategyEntry lookup_strategy(std::string const& label)
+        {
+            auto const& entries = strategies();
+
+            auto it = entries.find(label);
+            if (it == entries.end())
+                it = entries.find("*");
+
+            return it == entries.end() ? StrategyEntry{} : it->second;
+        }
+
+        struct no_validator
+        {
+        };
+
+    }    // namespace util
+
+    // Resilience chosen at runtime: the strategy, the number of replays or
+    // replicates of the kernels launched on the space are looked up by the
+    // label the space is constructed with, e.g.
+    //
+    //     KRS_RESILIENCE="stencil=none,checksum=replay:5,*=replicate"
+    //
+    // Replay requires a validator. Replicate without a validator is a
+    // majority vote of three results and takes no other count, with a
+    // validator the count of replicates is used. Kernels writing their
+    // results through CapturedViews can run unprotected, or replicated on
+    // host spaces without a validator; other strategies throw when they
+    // are launched.
+    template <typename ExecutionSpace, typename Validator = void>
+    class ResilientDynamic : public ExecutionSpace
+    {
+    public:
+        // Typedefs for the ResilientDynamic Execution Space
+        using base_execution_space = ExecutionSpace;
+        using validator_type = Validator;
+
+        using execution_space = ResilientDynamic;
+        using memory_space = typename ExecutionSpace::memory_space;
+        using device_type = typename ExecutionSpace::device_type;
+        using size_type = typename ExecutionSpace::size_type;
+        using scratch_memory_space =
+            typename ExecutionSpace::scratch_memory_space;
+
+        using stored_validator =
+            std::conditional_t<std::is_void<Validator>::value,
+                util::no_validator, Validator>;
+
+        template <typename V = Validator, typename... Args,
+            std::enable_if_t<std::is_void<V>::value, int> = 0>
+        ResilientDynamic(std::string const& label, Args&&... args)
+          : ExecutionSpace(args...)
+          , entry_(checked(util::lookup_strategy(label)))
+        {
+        }
+
+        template <typename V = Validator, typename... Args,
+            std::enable_if_t<!std::is_void<V>::value, int> = 0>
+        ResilientDynamic(
+            std::string const& label, V const& validator, Args&&... args)
+          : ExecutionSpace(args...)
+          , validator_(validator)
+          , entry_(checked(util::lookup_strategy(label)))
+        {
+        }
+
+        stored_validator const& validator() const noexcept
+        {
+            return validator_;
+        }
+
+        Strategy strategy() const noexcept
+        {
+            return entry_.strategy;
+        }
+
+        // Replays or replicates of the strategy
+        std::uint64_t count() const noexcept
+        {
+            return entry_.count;
+        }
+
+        KOKKOS_FUNCTION ResilientDynamic(
+            ResilientDynamic&& other) noexcept = default;
+        KOKKOS_FUNCTION ResilientDynamic(
+            ResilientDynamic const& other) = default;
+
+    private:
+        static util::StrategyEntry checked(util::StrategyEntry entry)
+        {
+            if (std::is_void<Validator>::value &&
+                entry.strategy == Strategy::replay)
+                throw std::runtime_error(
+                    "Replay requires a validator in ResilientDynamic.");
+            if (std::is_void<Validator>::value &&
+                entry.strategy == Strategy::replicate && entry.count != 3)
+                throw std::runtime_error(
+                    "Replicate without a validator is a vote of three in "
+                    "ResilientDynamic.");
+            return entry;
+        }
+
+        const stored_validator validator_{};
+        const util::StrategyEntry entry_;
+    };
+
+}}    // namespace Kokkos::resilience
+
+namespace Kokkos { namespace Tools { namespace Experimental {
+
+    template <typename ExecutionSpace, typename Validator>
+    struct DeviceTypeTraits<
+        Kokkos::resilience::ResilientDynamic<ExecutionSpace, Validator>>
+    {
+        static constexpr DeviceType id = DeviceTypeTraits<ExecutionSpace>::id;
+    };
+
+}}}    // namespace Kokkos::Tools::Experimental
@@ -0,0 +1,187 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <resilient_spaces/dynamic/dynamic_execution_space.hpp>
+
+#include <resilient_spaces/util/fault_flag.hpp>
+#include <resilient_spaces/util/functor.hpp>
+#include <resilient_spaces/util/traits.hpp>
+
+#include <stdexcept>
+#include <type_traits>
+
+namespace Kokkos { namespace Impl {
+
+    // Launches the functor with the strategy of the space, "none" runs the
+    // functor unwrapped on the base policy. Only the strategies the kernel
+    // supports are instantiated, so that protection can be turned off for
+    // any kernel at runtime. Configuring an unsupported one throws.
+    template <typename FunctorType, typename BasePolicy, typename Space>
+    void dispatch_dynamic(FunctorType const& functor,
+        BasePolicy const& policy, Space const& space)
+    {
+        using base_execution_space = typename Space::base_execution_space;
+        using validator_type = typename Space::validator_type;
+
+        // Validators check results, kernels writing their results can only
+        // be replicated through CapturedViews on the host
+        constexpr bool is_validated = !std::is_void<validator_type>::value;
+        constexpr bool returns_result = !std::is_void<
+            typename Kokkos::resilience::traits::kernel_result<FunctorType,
+                BasePolicy>::type>::value;
+        constexpr bool is_host = Kokkos::resilience::util::is_host_space<
+            base_execution_space>::value;
+
+        switch (space.strategy())
+        {
+        case Kokkos::resilience::Strategy::none:
+        {
+            // Call the underlying ParallelFor
+            ParallelFor<FunctorType, BasePolicy, base_execution_space>
+                closure(functor, policy);
+            closure.execute();
+            return;
+        }
+
+        case Kokkos::resilience::Strategy::replay:
+        {
+            if constexpr (is_validated && returns_result)
+            {
+                using functor_type =
+                    Kokkos::resilience::util::ResilientReplayValidateFunctor<
+                        base_execution_space, FunctorType, validator_type>;
+
+                functor_type inst(functor, space.validator(), space.count());
+
+                // Call the underlying ParallelFor
+                ParallelFor<functor_type, BasePolicy, base_execution_space>
+                    closure(inst, policy);
+                closure.execute();
+
+                if (inst.is_incorrect())
+                    throw std::runtime_error(
+                        "Program ran out of replay options.");
+                return;
+            }
+            else
+                throw std::runtime_error(
+                    "Replay requires a validated kernel returning its "
+                    "result in ResilientDynamic.");
+        }
+
+        case Kokkos::resilience::Strategy::replicate:
+        {
+            if constexpr (!is_validated && (returns_result || is_host))
+            {
+                using functor_type =
+                    Kokkos::resilience::util::ResilientReplicateFunctor<
+                        base_execution_space, FunctorType>;
+
+                functor_type inst(functor);
+
+                // Call the underlying ParallelFor
+                ParallelFor<functor_type, BasePolicy, base_execution_space>
+                    closure(inst, policy);
+                closure.execute();
+
+                if (inst.is_overflowed())
+                    throw std::runtime_error(
+                        "Captured writes exceeded the write log.");
+
+                if (inst.is_incorrect())
+                    throw std::runtime_error(
+                        "All replicates returned different results.");
+                return;
+            }
+            else if constexpr (is_validated && returns_result)
+            {
+                using functor_type = Kokkos::resilience::util::
+                    ResilientReplicateValidateFunctor<base_execution_space,
+                        FunctorType, validator_type>;
+
+                functor_type inst(functor, space.validator(), space.count());
+
+                // Call the underlying ParallelFor
+                ParallelFor<functor_type, BasePolicy, base_execution_space>
+                    closure(inst, policy);
+                closure.execute();
+
+                if (inst.is_incorrect())
+                    throw std::runtime_error(
+                        "All replicate returned incorrect result.");
+                return;
+            }
+            else
+                throw std::runtime_error(
+                    "Replicate requires a kernel returning its result, or "
+                    "an unvalidated host kernel, in ResilientDynamic.");
+        }
+        }
+    }
+
+    template <typename FunctorType, typename... Traits>
+    class ParallelFor<FunctorType, Kokkos::RangePolicy<Traits...>,
+        Kokkos::resilience::ResilientDynamic<
+            typename Kokkos::resilience::traits::RangePolicyExtracter<
+                Traits...>::base_execution_space,
+            typename Kokkos::resilience::traits::RangePolicyExtracter<
+                Traits...>::validator>>
+    {
+    public:
+        using Policy = Kokkos::RangePolicy<Traits...>;
+        using BasePolicy =
+            typename Kokkos::resilience::traits::RangePolicyExtracter<
+                Traits...>::RangePolicy;
+
+        ParallelFor(FunctorType const& arg_functor, Policy const& arg_policy)
+          : m_functor(arg_functor)
+          , m_policy(arg_policy)
+        {
+        }
+
+        void execute() const
+        {
+            dispatch_dynamic(m_functor, BasePolicy(m_policy), m_policy.space());
+        }
+
+    private:
+        const FunctorType m_functor;
+        const Policy m_policy;
+    };
+
+    template <typename FunctorType, typename... Traits>
+    class ParallelFor<FunctorType, Kokkos::MDRangePolicy<Traits...>,
+        Kokkos::resilience::ResilientDynamic<
+            typename Kokkos::resilience::traits::MDRangePolicyExtracter<
+                Traits...>::base_execution_space,
+            typename Kokkos::resilience::traits::MDRangePolicyExtracter<
+                Traits...>::validator>>
+    {
+    public:
+        using Policy = Kokkos::MDRangePolicy<Traits...>;
+        using BasePolicy =
+            typename Kokkos::resilience::traits::MDRangePolicyExtracter<
+                Traits...>::MDRangePolicy;
+
+        ParallelFor(FunctorType const& arg_functor, Policy const& arg_policy)
+          : m_functor(arg_functor)
+          , m_policy(arg_policy)
+        {
+        }
+
+        void execute() const
+        {
+            dispatch_dynamic(m_functor, BasePolicy(m_policy), m_policy.space());
+        }
+
+    private:
+        const FunctorType m_functor;
+        const Policy m_policy;
+    };
+
+}}    // namespace Kokkos::Impl
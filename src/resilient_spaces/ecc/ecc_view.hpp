@@ -0,0 +1,302 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <Kokkos_Core.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+// Software ECC for data at rest.
+//
+// Every 64-bit value is stored with an extended Hamming(72,64) code
+// (single error correction, double error detection) in a separate byte.
+// Check bits are parities of masked data words, computed with shifts and
+// xors only and without branches, so that loops encoding and decoding
+// words vectorize on any SIMD instruction set. Memory traffic grows by one
+// byte per value.
+namespace Kokkos { namespace resilience { namespace ecc {
+
+    namespace detail {
+
+        // Data bit j sits at the j-th position of the 72-bit codeword that
+        // is not a power of two (positions start at 1), check bit k covers
+        // the positions with bit k set.
+        constexpr std::uint64_t hamming_mask(int k)
+        {
+            std::uint64_t mask = 0;
+            int j = 0;
+            for (int p = 1; j != 64; ++p)
+            {
+                if ((p & (p - 1)) == 0)
+                    continue;
+                if ((p >> k) & 1)
+                    mask |= std::uint64_t(1) << j;
+                ++j;
+            }
+            return mask;
+        }
+
+        template <int K>
+        constexpr std::uint64_t mask = hamming_mask(K);
+
+        // Two words folded into the low and high half of one word, each
+        // half holding the parities of the lanes of its source word.
+        template <int Half>
+        KOKKOS_FORCEINLINE_FUNCTION std::uint64_t fold(
+            std::uint64_t low, std::uint64_t high, std::uint64_t lanes)
+        {
+            return ((low ^ (low >> Half)) & lanes) |
+                ((high ^ (high << Half)) & ~lanes);
+        }
+
+        // Bit k holds the parity of word & mask<k> for k < 7, bit 7 the
+        // parity of the word. The eight masked words are folded into the
+        // bytes of a single word (SWAR), which needs a fraction of the
+        // operations of eight separate parities.
+        KOKKOS_FORCEINLINE_FUNCTION std::uint64_t parities(std::uint64_t word)
+        {
+            constexpr std::uint64_t lanes32 = 0x00000000ffffffff;
+            constexpr std::uint64_t lanes16 = 0x0000ffff0000ffff;
+            constexpr std::uint64_t lanes8 = 0x00ff00ff00ff00ff;
+
+            // Byte k ends up with the parities of masked word k
+            std::uint64_t const x = fold<16>(
+                fold<32>(word & mask<0>, word & mask<4>, lanes32),
+                fold<32>(word & mask<2>, word & mask<6>, lanes32), lanes16);
+            std::uint64_t const y = fold<16>(
+                fold<32>(word & mask<1>, word & mask<5>, lanes32),
+                fold<32>(word & mask<3>, word, lanes32), lanes16);
+
+            std::uint64_t z = fold<8>(x, y, lanes8);
+            z ^= z >> 4;
+            z ^= z >> 2;
+            z ^= z >> 1;
+            z &= 0x0101010101010101;
+
+            // Gather the low bits of the bytes
+            z |= z >> 7;
+            z |= z >> 14;
+            z |= z >> 28;
+            return z & 0xff;
+        }
+
+        KOKKOS_FORCEINLINE_FUNCTION std::uint64_t parity(std::uint8_t byte)
+        {
+            std::uint64_t x = byte;
+            x ^= x >> 4;
+            x ^= x >> 2;
+            x ^= x >> 1;
+            return x & 1;
+        }
+
+        // Check bits 0-6 are the Hamming parities, bit 7 the parity of the
+        // data word and the other check bits.
+        KOKKOS_FORCEINLINE_FUNCTION std::uint8_t encode(std::uint64_t word)
+        {
+            std::uint64_t const p = parities(word);
+            std::uint8_t const check = std::uint8_t(p & 0x7f);
+
+            return std::uint8_t(check | ((p >> 7) ^ parity(check)) << 7);
+        }
+
+        // Data bits agreeing with the syndrome in check bit K
+        template <int K>
+        KOKKOS_FORCEINLINE_FUNCTION std::uint64_t select(
+            std::uint64_t syndrome)
+        {
+            return mask<K> ^ (((syndrome >> K) & 1) - 1);
+        }
+
+        enum status : int
+        {
+            intact = 0,
+            corrected = 1,
+            uncorrectable = 2
+        };
+
+        // Corrects a single flipped bit of the word or its check byte.
+        // Branch free, so that kernels decoding many words vectorize.
+        KOKKOS_FORCEINLINE_FUNCTION status decode(
+            std::uint64_t& word, std::uint8_t& check)
+        {
+            std::uint64_t const p = parities(word);
+            std::uint64_t const syndrome = (p ^ check) & 0x7f;
+            std::uint64_t const overall = (p >> 7) ^ parity(check);
+
+            // The data bit at position syndrome, if any, agrees with the
+            // syndrome in every check bit
+            std::uint64_t const flip = ~std::uint64_t(0) * overall &
+                select<0>(syndrome) & select<1>(syndrome) &
+                select<2>(syndrome) & select<3>(syndrome) &
+                select<4>(syndrome) & select<5>(syndrome) &
+                select<6>(syndrome);
+
+            // Otherwise a check bit or the overall parity bit flipped. All
+            // flags are 64-bit integers, mixing widths defeats vectorizing.
+            std::uint64_t const data_bit = flip != 0;
+            std::uint64_t const check_bit =
+                (syndrome & (syndrome - 1)) == 0;
+            std::uint64_t const correctable =
+                overall & (data_bit | check_bit);
+            std::uint64_t const error = (syndrome | overall) != 0;
+            std::uint64_t const fix = (1 - data_bit) *
+                (syndrome | std::uint64_t(syndrome == 0) << 7);
+
+            word ^= flip;
+            check = std::uint8_t(check ^ correctable * fix);
+
+            return status(error + (error & (1 - correctable)));
+        }
+
+        template <typename T>
+        KOKKOS_FORCEINLINE_FUNCTION std::uint64_t to_word(T const& value)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, &value, sizeof(word));
+            return word;
+        }
+
+        template <typename T>
+        KOKKOS_FORCEINLINE_FUNCTION T from_word(std::uint64_t word)
+        {
+            T value;
+            std::memcpy(&value, &word, sizeof(value));
+            return value;
+        }
+
+    }    // namespace detail
+
+    struct errors
+    {
+        std::uint64_t corrected = 0;
+        std::uint64_t uncorrectable = 0;
+    };
+
+    // Rank-1 View of 64-bit values protected by ECC. Values are read and
+    // written through load() and store() inside kernels; load() corrects
+    // single bit errors in memory and counts the errors it finds.
+    template <typename T,
+        typename MemorySpace = Kokkos::DefaultExecutionSpace::memory_space>
+    class EccView
+    {
+        static_assert(
+            sizeof(T) == 8 && std::is_trivially_copyable<T>::value,
+            "EccView protects trivially copyable 64-bit values.");
+
+    public:
+        using value_type = T;
+        using memory_space = MemorySpace;
+        using execution_space = typename MemorySpace::execution_space;
+
+        EccView() = default;
+
+        // Values start out zero, which encodes to a zero check byte
+        EccView(std::string const& label, std::size_t n)
+          : data_(label, n)
+          , check_(label + "_ecc", n)
+          , errors_(label + "_ecc_errors", 2)
+        {
+        }
+
+        KOKKOS_FUNCTION std::size_t size() const
+        {
+            return data_.extent(0);
+        }
+
+        KOKKOS_FUNCTION std::size_t extent(unsigned) const
+        {
+            return data_.extent(0);
+        }
+
+        KOKKOS_FORCEINLINE_FUNCTION void store(std::size_t i, T value) const
+        {
+            std::uint64_t const word = detail::to_word(value);
+            data_(i) = word;
+            check_(i) = detail::encode(word);
+        }
+
+        KOKKOS_FORCEINLINE_FUNCTION T load(std::size_t i) const
+        {
+            std::uint64_t word = data_(i);
+            std::uint8_t check = check_(i);
+
+            detail::status const status = detail::decode(word, check);
+            if (status != detail::intact)
+                record(i, word, check, status);
+
+            return detail::from_word<T>(word);
+        }
+
+        // Verifies and corrects every value, returns the number of values
+        // with uncorrectable errors found.
+        std::size_t scrub() const
+        {
+            EccView const self = *this;
+
+            std::size_t uncorrectable = 0;
+            Kokkos::parallel_reduce("krs_ecc_scrub",
+                Kokkos::RangePolicy<execution_space>(0, size()),
+                KOKKOS_LAMBDA(std::size_t i, std::size_t & count) {
+                    std::uint64_t word = self.data_(i);
+                    std::uint8_t check = self.check_(i);
+
+                    detail::status const status =
+                        detail::decode(word, check);
+                    if (status != detail::intact)
+                        self.record(i, word, check, status);
+
+                    count += status == detail::uncorrectable;
+                },
+                uncorrectable);
+            return uncorrectable;
+        }
+
+        // Errors found by load() and scrub() so far
+        ecc::errors errors() const
+        {
+            auto const host = Kokkos::create_mirror_view_and_copy(
+                Kokkos::HostSpace{}, errors_);
+            return {host(0), host(1)};
+        }
+
+        // Unprotected storage, e.g. to inject faults
+        Kokkos::View<std::uint64_t*, memory_space> const& words() const
+        {
+            return data_;
+        }
+
+        Kokkos::View<std::uint8_t*, memory_space> const& checks() const
+        {
+            return check_;
+        }
+
+    private:
+        KOKKOS_FUNCTION void record(std::size_t i, std::uint64_t word,
+            std::uint8_t check, detail::status status) const
+        {
+            if (status == detail::corrected)
+            {
+                data_(i) = word;
+                check_(i) = check;
+                Kokkos::atomic_fetch_add(&errors_(0), std::uint64_t(1));
+            }
+            else
+            {
+                Kokkos::atomic_fetch_add(&errors_(1), std::uint64_t(1));
+            }
+        }
+
+        Kokkos::View<std::uint64_t*, memory_space> data_;
+        Kokkos::View<std::uint8_t*, memory_space> check_;
+        Kokkos::View<std::uint64_t*, memory_space> errors_;
+    };
+
+}}}    // namespace Kokkos::resilience::ecc
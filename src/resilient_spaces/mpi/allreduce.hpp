@@ -0,0 +1,298 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Resilient allreduce of batched scalars.
+//
+// Every scalar travels with a redundant shadow holding its negation, reduced
+// with the dual operation (max <-> min, sum <-> sum). Negation is exact and
+// rounding is symmetric, so an intact result always satisfies
+// value == -shadow bit for bit, whatever order MPI reduces in. Ranks vote on
+// the validity of the result with a second, one-int allreduce and the batch is
+// only sent again when some rank saw a mismatch.
+//
+// A scalar added as a value is only protected in transit: its shadow is
+// derived from the value, so a value corrupted before it was added passes.
+// A scalar added as a function is evaluated twice on every attempt, once for
+// the value and once for the shadow, so a corrupted evaluation of the local
+// contribution is detected as well and evaluated again on the retry. The
+// function must compute the contribution independently of earlier results,
+// e.g. by reducing the local data again. A function returning a contribution
+// is evaluated once per attempt and computes both, e.g. with separate
+// accumulators in a single sweep over the local data.
+//
+// Batching all per-step scalars into one ResilientAllreduce keeps the cost at
+// two latency-bound collectives per batch.
+namespace Kokkos { namespace resilience { namespace mpi {
+
+    enum class reduce_op
+    {
+        sum = 0,
+        max = 1,
+        min = 2
+    };
+
+    // Local contribution and its shadow, the negation of the value
+    // computed independently of it.
+    struct contribution
+    {
+        double value;
+        double shadow;
+    };
+
+    namespace detail {
+
+        // {value, shadow, op}, the op is stored as a double so the payload
+        // is a single contiguous MPI datatype.
+        struct slot
+        {
+            double value;
+            double shadow;
+            double op;
+        };
+
+        // NaNs propagate through every operation so that value and shadow
+        // stay consistent.
+        inline double combine(reduce_op op, double a, double b) noexcept
+        {
+            if (a != a)
+                return a;
+            if (b != b)
+                return b;
+
+            switch (op)
+            {
+            case reduce_op::max:
+                return std::max(a, b);
+            case reduce_op::min:
+                return std::min(a, b);
+            default:
+                return a + b;
+            }
+        }
+
+        inline reduce_op dual(reduce_op op) noexcept
+        {
+            switch (op)
+            {
+            case reduce_op::max:
+                return reduce_op::min;
+            case reduce_op::min:
+                return reduce_op::max;
+            default:
+                return reduce_op::sum;
+            }
+        }
+
+        inline void reduce_slots(
+            void* in, void* inout, int* len, MPI_Datatype*) noexcept
+        {
+            slot const* lhs = static_cast<slot const*>(in);
+            slot* rhs = static_cast<slot*>(inout);
+
+            for (int i = 0; i != *len; ++i)
+            {
+                reduce_op const op = static_cast<reduce_op>(int(rhs[i].op));
+
+                rhs[i].value = combine(op, lhs[i].value, rhs[i].value);
+                rhs[i].shadow =
+                    combine(dual(op), lhs[i].shadow, rhs[i].shadow);
+            }
+        }
+
+        inline bool intact(slot const& s) noexcept
+        {
+            if (s.value != s.value)
+                return s.shadow != s.shadow;
+
+            return s.value == -s.shadow;
+        }
+
+    }    // namespace detail
+
+    class ResilientAllreduce
+    {
+    public:
+        // Called on the received payload before it is validated, used to
+        // emulate faults.
+        using fault_injector = std::function<void(double*, std::size_t)>;
+
+        explicit ResilientAllreduce(
+            MPI_Comm comm = MPI_COMM_WORLD, std::size_t max_retries = 3)
+          : comm_(comm)
+          , max_retries_(max_retries)
+        {
+            MPI_Type_contiguous(3, MPI_DOUBLE, &type_);
+            MPI_Type_commit(&type_);
+            MPI_Op_create(&detail::reduce_slots, 1, &op_);
+        }
+
+        ~ResilientAllreduce()
+        {
+            int finalized = 0;
+            MPI_Finalized(&finalized);
+            if (!finalized)
+            {
+                MPI_Op_free(&op_);
+                MPI_Type_free(&type_);
+            }
+        }
+
+        ResilientAllreduce(ResilientAllreduce const&) = delete;
+        ResilientAllreduce& operator=(ResilientAllreduce const&) = delete;
+
+        // Adds a scalar to the batch, returns its index in the results.
+        std::size_t add(double value, reduce_op op)
+        {
+            local_.push_back(
+                detail::slot{value, -value, double(static_cast<int>(op))});
+            evaluate_.emplace_back();
+            return local_.size() - 1;
+        }
+
+        // Adds a scalar computed by evaluate to the batch, returns its index
+        // in the results. evaluate is called twice per attempt.
+        template <typename Evaluate,
+            typename = std::enable_if_t<
+                std::is_invocable_r<double, Evaluate&>::value>>
+        std::size_t add(Evaluate evaluate, reduce_op op)
+        {
+            return add_contribution(
+                [evaluate = std::move(evaluate)]() mutable {
+                    double const value = evaluate();
+                    return contribution{value, -evaluate()};
+                },
+                op);
+        }
+
+        // Adds a scalar whose value and shadow are computed together by
+        // evaluate, returns its index in the results. evaluate is called
+        // once per attempt.
+        template <typename Evaluate,
+            typename = std::enable_if_t<
+                std::is_invocable_r<contribution, Evaluate&>::value>,
+            typename = void>
+        std::size_t add(Evaluate evaluate, reduce_op op)
+        {
+            return add_contribution(std::move(evaluate), op);
+        }
+
+        // Reduces the batch across the communicator, retrying until every
+        // rank received an intact result.
+        void execute()
+        {
+            std::size_t const n = local_.size();
+            result_.resize(n);
+
+            for (std::size_t attempt = 0; attempt <= max_retries_; ++attempt)
+            {
+                for (std::size_t i = 0; i != n; ++i)
+                {
+                    if (evaluate_[i])
+                    {
+                        contribution const local = evaluate_[i]();
+                        local_[i].value = local.value;
+                        local_[i].shadow = local.shadow;
+                    }
+                }
+
+                MPI_Allreduce(local_.data(), result_.data(), int(n), type_,
+                    op_, comm_);
+
+                if (injector_)
+                    injector_(reinterpret_cast<double*>(result_.data()),
+                        3 * n);
+
+                int corrupted = !std::all_of(
+                    result_.begin(), result_.end(), &detail::intact);
+                MPI_Allreduce(
+                    MPI_IN_PLACE, &corrupted, 1, MPI_INT, MPI_LOR, comm_);
+
+                if (!corrupted)
+                    return;
+
+                ++retries_;
+            }
+
+            throw std::runtime_error(
+                "Resilient allreduce failed to validate its result.");
+        }
+
+        double result(std::size_t index) const
+        {
+            if (index >= result_.size())
+                throw std::out_of_range("Resilient allreduce result index.");
+
+            return result_[index].value;
+        }
+
+        // Empties the batch, the retry count is kept.
+        void clear() noexcept
+        {
+            local_.clear();
+            evaluate_.clear();
+            result_.clear();
+        }
+
+        std::size_t size() const noexcept
+        {
+            return local_.size();
+        }
+
+        // Number of batches sent again because of a mismatch.
+        std::size_t retries() const noexcept
+        {
+            return retries_;
+        }
+
+        void set_fault_injector(fault_injector injector)
+        {
+            injector_ = std::move(injector);
+        }
+
+    private:
+        template <typename Evaluate>
+        std::size_t add_contribution(Evaluate evaluate, reduce_op op)
+        {
+            local_.push_back(
+                detail::slot{0., 0., double(static_cast<int>(op))});
+            evaluate_.emplace_back(std::move(evaluate));
+            return local_.size() - 1;
+        }
+
+        MPI_Comm comm_;
+        std::size_t max_retries_;
+        std::size_t retries_ = 0;
+        MPI_Datatype type_;
+        MPI_Op op_;
+        std::vector<detail::slot> local_;
+        std::vector<std::function<contribution()>> evaluate_;
+        std::vector<detail::slot> result_;
+        fault_injector injector_;
+    };
+
+    // Resilient allreduce of a single scalar.
+    inline double allreduce(
+        double value, reduce_op op, MPI_Comm comm = MPI_COMM_WORLD)
+    {
+        ResilientAllreduce reduction(comm);
+        std::size_t const index = reduction.add(value, op);
+        reduction.execute();
+        return reduction.result(index);
+    }
+
+}}}    // namespace Kokkos::resilience::mpi
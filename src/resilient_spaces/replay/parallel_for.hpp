@@ -7,12 +7,69 @@
 #pragma once
 
 #include <resilient_spaces/replay/replay_execution_space.hpp>
+#include <resilient_spaces/snapshot/dirty_page_tracker.hpp>
 
 #include <resilient_spaces/util/functor.hpp>
+#include <resilient_spaces/util/retry_queue.hpp>
 #include <resilient_spaces/util/traits.hpp>
 
 namespace Kokkos { namespace Impl {
 
+    // Functor, policy and the snapshot path shared by the RangePolicy and
+    // MDRangePolicy specializations below, Extracter is the policy extracter
+    // of the resilient policy and BasePolicy the policy it wraps.
+    template <typename FunctorType, typename Policy, typename BasePolicy,
+        typename Extracter>
+    class ReplayParallelForBase
+    {
+    public:
+        using validator_type = typename Extracter::validator;
+        using base_execution_space = typename Extracter::base_execution_space;
+
+        using validate_functor =
+            Kokkos::resilience::util::ResilientReplayValidateFunctor<
+                base_execution_space, FunctorType, validator_type>;
+        using snapshot_type =
+            ParallelFor<validate_functor, BasePolicy, base_execution_space>;
+
+    protected:
+        ReplayParallelForBase(
+            FunctorType const& arg_functor, Policy const& arg_policy)
+          : m_functor(arg_functor)
+          , m_policy(arg_policy)
+        {
+        }
+
+        // Replaying single indices is only correct if the functor does not
+        // update its inputs. With a snapshot every index is run once and the
+        // whole kernel is rolled back and replayed instead.
+        void execute_with_snapshot() const
+        {
+            Kokkos::resilience::snapshot::ScopedSnapshot snapshot(
+                m_policy.space().snapshot());
+
+            for (std::uint64_t n = 0; n != m_policy.space().replays(); ++n)
+            {
+                validate_functor inst(
+                    m_functor, m_policy.space().validator(), 1);
+
+                // Call the underlying ParallelFor
+                snapshot_type closure(inst, m_policy);
+                closure.execute();
+
+                if (!inst.is_incorrect())
+                    return;
+
+                snapshot.rollback();
+            }
+
+            throw std::runtime_error("Program ran out of replay options.");
+        }
+
+        const FunctorType m_functor;
+        const Policy m_policy;
+    };
+
     template <typename FunctorType, typename... Traits>
     class ParallelFor<FunctorType, Kokkos::RangePolicy<Traits...>,
         Kokkos::resilience::ResilientReplay<
@@ -20,48 +77,124 @@ namespace Kokkos { namespace Impl {
                 Traits...>::base_execution_space,
             typename Kokkos::resilience::traits::RangePolicyExtracter<
                 Traits...>::validator>>
+      : public ReplayParallelForBase<FunctorType,
+            Kokkos::RangePolicy<Traits...>,
+            typename Kokkos::resilience::traits::RangePolicyExtracter<
+                Traits...>::RangePolicy,
+            Kokkos::resilience::traits::RangePolicyExtracter<Traits...>>
     {
     public:
         using Policy = Kokkos::RangePolicy<Traits...>;
         using BasePolicy =
             typename Kokkos::resilience::traits::RangePolicyExtracter<
                 Traits...>::RangePolicy;
-        using validator_type =
-            typename Kokkos::resilience::traits::RangePolicyExtracter<
-                Traits...>::validator;
-        using base_execution_space =
-            typename Kokkos::resilience::traits::RangePolicyExtracter<
-                Traits...>::base_execution_space;
-
-        using base_type = ParallelFor<
-            Kokkos::resilience::util::ResilientReplayValidateFunctor<
-                base_execution_space, FunctorType, validator_type>,
-            BasePolicy, base_execution_space>;
-
+        using replay_base = ReplayParallelForBase<FunctorType, Policy,
+            BasePolicy,
+            Kokkos::resilience::traits::RangePolicyExtracter<Traits...>>;
+
+        using typename replay_base::base_execution_space;
+        using typename replay_base::validator_type;
+
+        using index_type = typename BasePolicy::index_type;
+        using work_tag = typename BasePolicy::work_tag;
+
+        using queue_type = Kokkos::resilience::util::RetryQueue<
+            base_execution_space, index_type>;
+        using queue_functor =
+            Kokkos::resilience::util::ResilientReplayQueueFunctor<
+                base_execution_space, FunctorType, validator_type, work_tag,
+                index_type>;
+        using drain_functor =
+            Kokkos::resilience::util::ResilientReplayDrainFunctor<
+                base_execution_space, FunctorType, validator_type, work_tag,
+                index_type>;
+        using drain_policy = Kokkos::RangePolicy<base_execution_space,
+            Kokkos::Schedule<Kokkos::Dynamic>, Kokkos::IndexType<std::size_t>>;
+
+        using base_type =
+            ParallelFor<queue_functor, BasePolicy, base_execution_space>;
+
+        // The queues and the closure of the primary pass are built once,
+        // so that relaunching the closure (see LaunchPlan) allocates
+        // nothing.
         ParallelFor(FunctorType const& arg_functor, Policy const& arg_policy)
-          : m_functor(arg_functor)
-          , m_policy(arg_policy)
+          : replay_base(arg_functor, arg_policy)
+          , m_queues{queue(arg_policy, 0), queue(arg_policy, 1)}
+          , m_inst(arg_functor, arg_policy.space().validator(),
+                arg_policy.space().replays(), m_queues[0])
+          , m_closure(m_inst, arg_policy)
         {
         }
 
         void execute() const
         {
-            Kokkos::resilience::util::ResilientReplayValidateFunctor<
-                base_execution_space, FunctorType, validator_type>
-                inst(m_functor, m_policy.space().validator(),
-                    m_policy.space().replays());
+            if (m_policy.space().snapshot() != nullptr)
+                return execute_with_snapshot();
 
-            // Call the underlying ParallelFor
-            base_type closure(inst, m_policy);
-            closure.execute();
+            validator_type const& validator = m_policy.space().validator();
+            std::uint64_t const replays = m_policy.space().replays();
 
-            if (inst.is_incorrect())
+            m_inst.reset();
+
+            // Call the underlying ParallelFor
+            m_closure.execute();
+
+            bool incorrect = m_inst.is_incorrect();
+
+            // Failed indices are retried in rounds with a dynamic schedule,
+            // so that a burst of failures is spread over all threads
+            // instead of stalling the thread it hit. Rounds alternate
+            // between the two queues. The primary queue is left empty for
+            // the next launch, so launches without failures never clear it.
+            std::size_t const failed = m_queues[0].count();
+            std::size_t pushed = failed;
+            for (std::uint64_t n = 1; pushed != 0 && n < replays; ++n)
+            {
+                queue_type const& queue = m_queues[(n - 1) % 2];
+                queue_type const& next = m_queues[n % 2];
+
+                next.clear();
+                drain_functor drain(m_functor, validator, queue,
+                    queue.queued(pushed), next, replays - n - 1);
+
+                ParallelFor<drain_functor, drain_policy, base_execution_space>
+                    retry(drain,
+                        drain_policy(
+                            m_policy.space(), 0, queue.slots(pushed)));
+                retry.execute();
+
+                incorrect = incorrect || drain.is_incorrect();
+                pushed = next.count();
+            }
+
+            if (failed != 0)
+                m_queues[0].clear();
+
+            if (incorrect)
                 throw std::runtime_error("Program ran out of replay options.");
         }
 
     private:
-        const FunctorType m_functor;
-        const Policy m_policy;
+        // A queue first written in the given round (0 is the primary pass)
+        // is only needed while attempts remain after that round
+        static queue_type queue(Policy const& policy, std::uint64_t round)
+        {
+            if (policy.space().replays() <= round + 1)
+                return queue_type();
+
+            std::size_t const range =
+                std::size_t(policy.end() - policy.begin());
+            return queue_type(queue_type::replay_capacity(range),
+                policy.begin(), policy.end());
+        }
+
+        using replay_base::execute_with_snapshot;
+        using replay_base::m_functor;
+        using replay_base::m_policy;
+
+        const queue_type m_queues[2];
+        const queue_functor m_inst;
+        const base_type m_closure;
     };
 
     template <typename FunctorType, typename... Traits>
@@ -71,36 +204,38 @@ namespace Kokkos { namespace Impl {
                 Traits...>::base_execution_space,
             typename Kokkos::resilience::traits::MDRangePolicyExtracter<
                 Traits...>::validator>>
+      : public ReplayParallelForBase<FunctorType,
+            Kokkos::MDRangePolicy<Traits...>,
+            typename Kokkos::resilience::traits::MDRangePolicyExtracter<
+                Traits...>::MDRangePolicy,
+            Kokkos::resilience::traits::MDRangePolicyExtracter<Traits...>>
     {
     public:
         using Policy = Kokkos::MDRangePolicy<Traits...>;
         using BasePolicy =
             typename Kokkos::resilience::traits::MDRangePolicyExtracter<
                 Traits...>::MDRangePolicy;
-        using validator_type =
-            typename Kokkos::resilience::traits::MDRangePolicyExtracter<
-                Traits...>::validator;
-        using base_execution_space =
-            typename Kokkos::resilience::traits::MDRangePolicyExtracter<
-                Traits...>::base_execution_space;
+        using replay_base = ReplayParallelForBase<FunctorType, Policy,
+            BasePolicy,
+            Kokkos::resilience::traits::MDRangePolicyExtracter<Traits...>>;
 
-        using base_type = ParallelFor<
-            Kokkos::resilience::util::ResilientReplayValidateFunctor<
-                base_execution_space, FunctorType, validator_type>,
-            BasePolicy, base_execution_space>;
+        using typename replay_base::base_execution_space;
+        using typename replay_base::validator_type;
+
+        using base_type = typename replay_base::snapshot_type;
 
         ParallelFor(FunctorType const& arg_functor, Policy const& arg_policy)
-          : m_functor(arg_functor)
-          , m_policy(arg_policy)
+          : replay_base(arg_functor, arg_policy)
         {
         }
 
         void execute() const
         {
-            Kokkos::resilience::util::ResilientReplayValidateFunctor<
-                base_execution_space, FunctorType, validator_type>
-                inst(m_functor, m_policy.space().validator(),
-                    m_policy.space().replays());
+            if (m_policy.space().snapshot() != nullptr)
+                return execute_with_snapshot();
+
+            typename replay_base::validate_functor inst(m_functor,
+                m_policy.space().validator(), m_policy.space().replays());
 
             // Call the underlying ParallelFor
             base_type closure(inst, m_policy);
@@ -111,8 +246,9 @@ namespace Kokkos { namespace Impl {
         }
 
     private:
-        const FunctorType m_functor;
-        const Policy m_policy;
+        using replay_base::execute_with_snapshot;
+        using replay_base::m_functor;
+        using replay_base::m_policy;
     };
 
 }}    // namespace Kokkos::Impl
@@ -7,40 +7,34 @@
 #pragma once
 
 #include <resilient_spaces/replay/replay_execution_space.hpp>
+#include <resilient_spaces/snapshot/dirty_page_tracker.hpp>
 
 #include <resilient_spaces/util/functor.hpp>
+#include <resilient_spaces/util/reduction_result.hpp>
 #include <resilient_spaces/util/traits.hpp>
 
+#include <stdexcept>
+#include <type_traits>
+
 namespace Kokkos { namespace Impl {
 
-    template <typename FunctorType, typename ReducerType, typename... Traits>
-    class ParallelReduce<FunctorType, Kokkos::RangePolicy<Traits...>,
-        ReducerType,
-        Kokkos::resilience::ResilientReplay<
-            typename Kokkos::resilience::traits::RangePolicyExtracter<
-                Traits...>::base_execution_space,
-            typename Kokkos::resilience::traits::RangePolicyExtracter<
-                Traits...>::validator>>
+    // Replayed reduction shared by the RangePolicy and MDRangePolicy
+    // specializations below, Extracter is the policy extracter of the
+    // resilient policy and BasePolicy the policy it wraps.
+    template <typename FunctorType, typename Policy, typename BasePolicy,
+        typename ReducerType, typename Extracter>
+    class ReplayParallelReduceBase
     {
     public:
-        using Policy = Kokkos::RangePolicy<Traits...>;
-        using BasePolicy =
-            typename Kokkos::resilience::traits::RangePolicyExtracter<
-                Traits...>::RangePolicy;
-        using validator_type =
-            typename Kokkos::resilience::traits::RangePolicyExtracter<
-                Traits...>::validator;
-        using base_execution_space =
-            typename Kokkos::resilience::traits::RangePolicyExtracter<
-                Traits...>::base_execution_space;
+        using validator_type = typename Extracter::validator;
+        using base_execution_space = typename Extracter::base_execution_space;
 
         using base_type = ParallelReduce<FunctorType, BasePolicy, ReducerType,
             base_execution_space>;
 
-        // Reducer specific typedefs
+        // Reducer specific typedefs, tiles of an MDRangePolicy are kept by
+        // the base policy
         using WorkTag = typename Policy::work_tag;
-        using WorkRange = typename Policy::WorkRange;
-        using Member = typename Policy::member_type;
 
         using Analysis = FunctorAnalysis<FunctorPatternInterface::REDUCE,
             BasePolicy, FunctorType>;
@@ -49,33 +43,52 @@ namespace Kokkos { namespace Impl {
         using pointer_type = typename Analysis::pointer_type;
         using reference_type = typename Analysis::reference_type;
 
-        ParallelReduce(FunctorType const& arg_functor, Policy const& arg_policy,
-            const ReducerType& reducer)
-          : m_functor(arg_functor)
-          , m_policy(arg_policy)
-          , m_reducer(reducer)
-          , m_result_ptr(reducer.view().data())
+        // Array reductions have a runtime value_count and are validated
+        // with a pointer to all values
+        static constexpr bool is_array_reduction = !Analysis::StaticValueSize;
+
+        // The closure and the result buffers are built once, so that the
+        // attempts allocate nothing.
+        ReplayParallelReduceBase(FunctorType const& arg_functor,
+            Policy const& arg_policy, const ReducerType& reducer)
+          : m_policy(arg_policy)
+          , m_result(base_space(arg_policy), reducer.view(), 1)
+          , m_closure(arg_functor, arg_policy, reducer)
+        {
+        }
+
+        template <typename ViewType>
+        ReplayParallelReduceBase(FunctorType const& arg_functor,
+            Policy const& arg_policy, ViewType const& result,
+            std::enable_if_t<Kokkos::is_view<ViewType>::value &&
+                !Kokkos::is_reducer<ReducerType>::value>* = nullptr)
+          : m_policy(arg_policy)
+          , m_result(base_space(arg_policy), result,
+                Analysis::value_count(arg_functor))
+          , m_closure(arg_functor, arg_policy, result)
         {
         }
 
         void execute() const
         {
             bool is_correct{false};
-            auto initial_value = *m_result_ptr;
+            m_result.save();
+
+            Kokkos::resilience::snapshot::ScopedSnapshot snapshot(
+                m_policy.space().snapshot());
+
             for (std::size_t i = 0; i != m_policy.space().replays(); ++i)
             {
-                base_type closure(m_functor, m_policy, m_reducer);
-                closure.execute();
+                m_closure.execute();
 
-                bool result = m_policy.space().validator()(*m_result_ptr);
-
-                if (result)
+                if (validate(m_result.read()))
                 {
                     is_correct = true;
                     break;
                 }
 
-                *m_result_ptr = initial_value;
+                m_result.restore();
+                snapshot.rollback();
             }
 
             if (!is_correct)
@@ -83,9 +96,84 @@ namespace Kokkos { namespace Impl {
         }
 
     private:
-        const FunctorType m_functor;
+        static base_execution_space base_space(Policy const& policy)
+        {
+            return policy.space();
+        }
+
+        bool validate(pointer_type values) const
+        {
+            if constexpr (is_array_reduction)
+                return Kokkos::resilience::traits::invoke_result_validator<
+                    WorkTag>(m_policy.space().validator(), values);
+            else
+                return Kokkos::resilience::traits::invoke_result_validator<
+                    WorkTag>(m_policy.space().validator(), *values);
+        }
+
         const Policy m_policy;
-        const ReducerType m_reducer;
-        const pointer_type m_result_ptr;
+        const Kokkos::resilience::util::ReductionResult<value_type,
+            base_execution_space>
+            m_result;
+        const base_type m_closure;
+    };
+
+    template <typename FunctorType, typename ReducerType, typename... Traits>
+    class ParallelReduce<FunctorType, Kokkos::RangePolicy<Traits...>,
+        ReducerType,
+        Kokkos::resilience::ResilientReplay<
+            typename Kokkos::resilience::traits::RangePolicyExtracter<
+                Traits...>::base_execution_space,
+            typename Kokkos::resilience::traits::RangePolicyExtracter<
+                Traits...>::validator>>
+      : public ReplayParallelReduceBase<FunctorType,
+            Kokkos::RangePolicy<Traits...>,
+            typename Kokkos::resilience::traits::RangePolicyExtracter<
+                Traits...>::RangePolicy,
+            ReducerType,
+            Kokkos::resilience::traits::RangePolicyExtracter<Traits...>>
+    {
+    public:
+        using Policy = Kokkos::RangePolicy<Traits...>;
+        using BasePolicy =
+            typename Kokkos::resilience::traits::RangePolicyExtracter<
+                Traits...>::RangePolicy;
+
+        using WorkRange = typename Policy::WorkRange;
+        using Member = typename Policy::member_type;
+
+        using replay_base = ReplayParallelReduceBase<FunctorType, Policy,
+            BasePolicy, ReducerType,
+            Kokkos::resilience::traits::RangePolicyExtracter<Traits...>>;
+
+        using replay_base::replay_base;
+    };
+
+    template <typename FunctorType, typename ReducerType, typename... Traits>
+    class ParallelReduce<FunctorType, Kokkos::MDRangePolicy<Traits...>,
+        ReducerType,
+        Kokkos::resilience::ResilientReplay<
+            typename Kokkos::resilience::traits::MDRangePolicyExtracter<
+                Traits...>::base_execution_space,
+            typename Kokkos::resilience::traits::MDRangePolicyExtracter<
+                Traits...>::validator>>
+      : public ReplayParallelReduceBase<FunctorType,
+            Kokkos::MDRangePolicy<Traits...>,
+            typename Kokkos::resilience::traits::MDRangePolicyExtracter<
+                Traits...>::MDRangePolicy,
+            ReducerType,
+            Kokkos::resilience::traits::MDRangePolicyExtracter<Traits...>>
+    {
+    public:
+        using Policy = Kokkos::MDRangePolicy<Traits...>;
+        using BasePolicy =
+            typename Kokkos::resilience::traits::MDRangePolicyExtracter<
+                Traits...>::MDRangePolicy;
+
+        using replay_base = ReplayParallelReduceBase<FunctorType, Policy,
+            BasePolicy, ReducerType,
+            Kokkos::resilience::traits::MDRangePolicyExtracter<Traits...>>;
+
+        using replay_base::replay_base;
     };
 }}    // namespace Kokkos::Impl
\ No newline at end of file
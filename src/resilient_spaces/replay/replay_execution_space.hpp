@@ -10,6 +10,10 @@
 
 namespace Kokkos { namespace resilience {
 
+    namespace snapshot {
+        class DirtyPageTracker;
+    }
+
     template <typename ExecutionSpace, typename Validator>
     class ResilientReplay : public ExecutionSpace
     {
@@ -45,6 +49,23 @@ namespace Kokkos { namespace resilience {
             return replays_;
         }
 
+        // Kernels launched on this space snapshot the memory registered with
+        // the tracker and roll it back before replaying a failed kernel. This
+        // makes kernels that update their inputs in place replay-correct.
+        void set_snapshot(snapshot::DirtyPageTracker* tracker) noexcept
+        {
+            static_assert(Kokkos::SpaceAccessibility<ExecutionSpace,
+                              Kokkos::HostSpace>::accessible,
+                "Dirty page snapshots require a host execution space.");
+
+            snapshot_ = tracker;
+        }
+
+        snapshot::DirtyPageTracker* snapshot() const noexcept
+        {
+            return snapshot_;
+        }
+
         KOKKOS_FUNCTION ResilientReplay(
             ResilientReplay&& other) noexcept = default;
         KOKKOS_FUNCTION ResilientReplay(ResilientReplay const& other) = default;
@@ -52,6 +73,7 @@ namespace Kokkos { namespace resilience {
     private:
         const Validator validator_;
         const std::uint64_t replays_;
+        snapshot::DirtyPageTracker* snapshot_ = nullptr;
     };
 
 }}    // namespace Kokkos::resilience
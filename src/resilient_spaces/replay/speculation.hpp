@@ -0,0 +1,219 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <Kokkos_Core.hpp>
+
+#include <resilient_spaces/replay/replay_execution_space.hpp>
+#include <resilient_spaces/replay/transaction.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Speculative execution of dependent steps.
+//
+// A step enqueues kernels on the base execution space and is validated
+// asynchronously on a host thread while the following steps are already
+// running on its unvalidated output. The execution space instance is only
+// used by the launching thread: it fences after every step, and the
+// validation starts once the step completed. The validator of the
+// ResilientReplay space is called with the step index and must only read
+// state captured by that step (e.g. a per-step slot of a result View),
+// since later steps may be running while it is evaluated. It must not
+// enqueue work on the instance of the speculation. Validations run one at a
+// time, in step order.
+//
+// Steps are grouped in windows. Participants are saved at the beginning of
+// a window and committed once every step of the window validated. If a step
+// is rejected, the participants are restored and the window is replayed
+// step by step with synchronous validation. The last window is synchronized
+// by synchronize() or, at the latest, by the destructor.
+namespace Kokkos { namespace resilience {
+
+    template <typename ExecutionSpace, typename Validator>
+    class ResilientSpeculation
+    {
+    public:
+        using resilient_space = ResilientReplay<ExecutionSpace, Validator>;
+
+        explicit ResilientSpeculation(
+            resilient_space const& space, std::size_t window = 4)
+          : space_(space)
+          , window_(window == 0 ? 1 : window)
+        {
+        }
+
+        ResilientSpeculation(ResilientSpeculation const&) = delete;
+        ResilientSpeculation& operator=(ResilientSpeculation const&) = delete;
+
+        // Synchronizes the outstanding steps. A window running out of
+        // replays aborts, as destructors cannot throw. While unwinding from
+        // another exception the validations are only waited for.
+        ~ResilientSpeculation()
+        {
+            if (std::uncaught_exceptions() != 0)
+            {
+                for (auto& validation : pending_)
+                    validation.wait();
+                return;
+            }
+
+            try
+            {
+                synchronize();
+            }
+            catch (std::exception const& e)
+            {
+                Kokkos::abort(e.what());
+            }
+        }
+
+        // Restores the View when a window is replayed.
+        template <typename ViewType>
+        void protect(ViewType const& view)
+        {
+            participants_.emplace_back(
+                new detail::view_participant<ExecutionSpace, ViewType>(
+                    base_space(), view));
+        }
+
+        // The participant is referenced and must outlive the speculation.
+        template <typename Participant>
+        void enlist(Participant& participant)
+        {
+            participants_.emplace_back(
+                new detail::object_participant<Participant>(participant));
+        }
+
+        // Enqueues step(index) and returns without waiting for its
+        // validation. The step is kept until its window is committed and
+        // must be replayable.
+        template <typename Step>
+        void step(Step&& step)
+        {
+            if (steps_.empty())
+            {
+                for (auto& participant : participants_)
+                    participant->save();
+                first_ = next_;
+            }
+
+            std::size_t const index = next_++;
+            steps_.emplace_back(std::forward<Step>(step));
+            steps_.back()(index);
+            base_space().fence();
+
+            pending_.push_back(validate_async(index));
+
+            if (pending_.size() == window_)
+                synchronize();
+        }
+
+        // Waits for the outstanding validations, replays the window if one
+        // of them failed.
+        void synchronize()
+        {
+            if (steps_.empty())
+                return;
+
+            bool valid = true;
+            for (auto& validation : pending_)
+                valid = validation.get() && valid;
+            pending_.clear();
+            last_ = std::shared_future<bool>();
+
+            if (!valid)
+                replay();
+
+            for (auto& participant : participants_)
+                participant->commit();
+            steps_.clear();
+        }
+
+        // Number of windows rolled back.
+        std::uint64_t rollbacks() const noexcept
+        {
+            return rollbacks_;
+        }
+
+        // Number of steps enqueued so far.
+        std::size_t steps() const noexcept
+        {
+            return next_;
+        }
+
+    private:
+        ExecutionSpace const& base_space() const noexcept
+        {
+            return space_;
+        }
+
+        // Validations are chained so that the validator is never called
+        // concurrently with itself. The step has completed, the validation
+        // does not touch the instance.
+        std::shared_future<bool> validate_async(std::size_t index)
+        {
+            Validator validator = space_.validator();
+            std::shared_future<bool> previous = last_;
+
+            auto validation = [validator, previous, index] {
+                if (previous.valid())
+                    previous.wait();
+
+                return validator(index);
+            };
+            last_ = std::async(std::launch::async, validation).share();
+
+            return last_;
+        }
+
+        void replay()
+        {
+            base_space().fence();
+            ++rollbacks_;
+
+            for (std::uint64_t n = 1; n < space_.replays(); ++n)
+            {
+                for (auto& participant : participants_)
+                    participant->restore();
+
+                bool valid = true;
+                for (std::size_t s = 0; valid && s != steps_.size(); ++s)
+                {
+                    steps_[s](first_ + s);
+                    base_space().fence();
+                    valid = space_.validator()(first_ + s);
+                }
+
+                if (valid)
+                    return;
+            }
+
+            steps_.clear();
+            throw std::runtime_error("Program ran out of replay options.");
+        }
+
+        resilient_space space_;
+        std::size_t window_;
+        std::size_t first_ = 0;
+        std::size_t next_ = 0;
+        std::uint64_t rollbacks_ = 0;
+        std::vector<std::function<void(std::size_t)>> steps_;
+        std::vector<std::unique_ptr<detail::transaction_participant>>
+            participants_;
+        std::shared_future<bool> last_;
+        std::vector<std::shared_future<bool>> pending_;
+    };
+
+}}    // namespace Kokkos::resilience
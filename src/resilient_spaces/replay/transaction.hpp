@@ -0,0 +1,229 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <Kokkos_Core.hpp>
+
+#include <resilient_spaces/replay/replay_execution_space.hpp>
+#include <resilient_spaces/snapshot/dirty_page_tracker.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Groups of dependent kernels validated and replayed as one unit.
+//
+// Kernels enqueued on a transaction run back-to-back on the base execution
+// space without validation or host synchronization in between. Once all of
+// them completed, the validator of the ResilientReplay space is called
+// without arguments. If it rejects the result, every participant is restored
+// to its state at the beginning of the transaction and the whole group is
+// replayed.
+//
+// Participants are protected Views or any object providing save(), restore()
+// and commit().
+namespace Kokkos { namespace resilience {
+
+    namespace detail {
+
+        class transaction_participant
+        {
+        public:
+            virtual ~transaction_participant() = default;
+
+            // Called before the first attempt
+            virtual void save() = 0;
+
+            // Called before every replay
+            virtual void restore() = 0;
+
+            // Called once the group was validated
+            virtual void commit() = 0;
+        };
+
+        template <typename ExecutionSpace, typename ViewType>
+        class view_participant : public transaction_participant
+        {
+        public:
+            view_participant(ExecutionSpace const& space, ViewType const& view)
+              : space_(space)
+              , view_(view)
+              , backup_(Kokkos::create_mirror(
+                    typename ViewType::memory_space{}, view))
+            {
+            }
+
+            void save() override
+            {
+                Kokkos::deep_copy(space_, backup_, view_);
+            }
+
+            void restore() override
+            {
+                Kokkos::deep_copy(space_, view_, backup_);
+            }
+
+            void commit() override {}
+
+        private:
+            ExecutionSpace space_;
+            ViewType view_;
+            decltype(Kokkos::create_mirror(
+                typename ViewType::memory_space{}, std::declval<ViewType>()))
+                backup_;
+        };
+
+        template <typename Participant>
+        class object_participant : public transaction_participant
+        {
+        public:
+            explicit object_participant(Participant& participant)
+              : participant_(participant)
+            {
+            }
+
+            void save() override
+            {
+                participant_.save();
+            }
+
+            void restore() override
+            {
+                participant_.restore();
+            }
+
+            void commit() override
+            {
+                participant_.commit();
+            }
+
+        private:
+            Participant& participant_;
+        };
+
+    }    // namespace detail
+
+    template <typename ExecutionSpace, typename Validator>
+    class ResilientTransaction
+    {
+    public:
+        using resilient_space = ResilientReplay<ExecutionSpace, Validator>;
+
+        explicit ResilientTransaction(resilient_space const& space)
+          : space_(space)
+        {
+        }
+
+        ResilientTransaction(ResilientTransaction const&) = delete;
+        ResilientTransaction& operator=(ResilientTransaction const&) = delete;
+
+        // Restores the View before every replay of the group. Only Views
+        // updated in place (read and written by the group) need protection.
+        template <typename ViewType>
+        void protect(ViewType const& view)
+        {
+            participants_.emplace_back(
+                new detail::view_participant<ExecutionSpace, ViewType>(
+                    base_space(), view));
+        }
+
+        // The participant is referenced and must outlive execute().
+        template <typename Participant>
+        void enlist(Participant& participant)
+        {
+            participants_.emplace_back(
+                new detail::object_participant<Participant>(participant));
+        }
+
+        // Enqueues a kernel, policies must run on the base execution space.
+        template <typename Policy, typename Functor>
+        void parallel_for(
+            std::string label, Policy const& policy, Functor const& functor)
+        {
+            kernels_.emplace_back([label = std::move(label), policy, functor] {
+                Kokkos::parallel_for(label, policy, functor);
+            });
+        }
+
+        // The result must be a View (or a reducer holding one) so the
+        // reduction does not synchronize with the host.
+        template <typename Policy, typename Functor, typename Result>
+        void parallel_reduce(std::string label, Policy const& policy,
+            Functor const& functor, Result const& result)
+        {
+            kernels_.emplace_back(
+                [label = std::move(label), policy, functor, result] {
+                    Kokkos::parallel_reduce(label, policy, functor, result);
+                });
+        }
+
+        // Runs the group until the validator accepts it or the space runs
+        // out of replays. Kernels and participants are consumed.
+        void execute()
+        {
+            snapshot::ScopedSnapshot snapshot(space_.snapshot());
+
+            for (auto& participant : participants_)
+                participant->save();
+
+            bool valid = false;
+            for (std::uint64_t n = 0; n != space_.replays(); ++n)
+            {
+                if (n != 0)
+                {
+                    snapshot.rollback();
+                    for (auto& participant : participants_)
+                        participant->restore();
+                    ++replayed_;
+                }
+
+                for (auto& kernel : kernels_)
+                    kernel();
+                base_space().fence();
+
+                valid = space_.validator()();
+                if (valid)
+                    break;
+            }
+
+            if (valid)
+            {
+                for (auto& participant : participants_)
+                    participant->commit();
+            }
+
+            kernels_.clear();
+            participants_.clear();
+
+            if (!valid)
+                throw std::runtime_error("Program ran out of replay options.");
+        }
+
+        // Number of times a group was replayed.
+        std::uint64_t replayed() const noexcept
+        {
+            return replayed_;
+        }
+
+    private:
+        ExecutionSpace const& base_space() const noexcept
+        {
+            return space_;
+        }
+
+        resilient_space space_;
+        std::vector<std::function<void()>> kernels_;
+        std::vector<std::unique_ptr<detail::transaction_participant>>
+            participants_;
+        std::uint64_t replayed_ = 0;
+    };
+
+}}    // namespace Kokkos::resilience
@@ -9,8 +9,14 @@
 #include <resilient_spaces/replicate/replicate_execution_space.hpp>
 
 #include <resilient_spaces/util/functor.hpp>
+#include <resilient_spaces/util/retry_queue.hpp>
+#include <resilient_spaces/util/scratch_arena.hpp>
 #include <resilient_spaces/util/traits.hpp>
 
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
 namespace Kokkos { namespace Impl {
 
     template <typename FunctorType, typename... Traits>
@@ -156,6 +162,10 @@ namespace Kokkos { namespace Impl {
             base_type closure(inst, m_policy);
             closure.execute();
 
+            if (inst.is_overflowed())
+                throw std::runtime_error(
+                    "Captured writes exceeded the write log.");
+
             if (inst.is_incorrect())
                 throw std::runtime_error(
                     "All replicates returned different results.");
@@ -188,8 +198,7 @@ namespace Kokkos { namespace Impl {
 
         ParallelFor(FunctorType const& arg_functor, Policy const& arg_policy)
           : m_functor(arg_functor)
-          , m_policy(base_execution_space{arg_policy.space()},
-                arg_policy.m_lower, arg_policy.m_upper)
+          , m_policy(arg_policy)
         {
         }
 
@@ -203,6 +212,10 @@ namespace Kokkos { namespace Impl {
             base_type closure(inst, m_policy);
             closure.execute();
 
+            if (inst.is_overflowed())
+                throw std::runtime_error(
+                    "Captured writes exceeded the write log.");
+
             if (inst.is_incorrect())
                 throw std::runtime_error(
                     "All replicates returned different results.");
@@ -213,4 +226,374 @@ namespace Kokkos { namespace Impl {
         const BasePolicy m_policy;
     };
 
+    template <typename FunctorType, typename... Traits>
+    class ParallelFor<FunctorType, Kokkos::RangePolicy<Traits...>,
+        Kokkos::resilience::ResilientReplicateDiverse<
+            typename Kokkos::resilience::traits::RangePolicyExtracter<
+                Traits...>::base_execution_space>>
+    {
+    public:
+        using Policy = Kokkos::RangePolicy<Traits...>;
+        using BasePolicy =
+            typename Kokkos::resilience::traits::RangePolicyExtracter<
+                Traits...>::RangePolicy;
+        using base_execution_space =
+            typename Kokkos::resilience::traits::RangePolicyExtracter<
+                Traits...>::base_execution_space;
+
+        using index_type = typename BasePolicy::index_type;
+        using work_tag = typename BasePolicy::work_tag;
+        using result_type = std::decay_t<decltype(
+            Kokkos::resilience::traits::invoke_tagged<work_tag>(
+                std::declval<FunctorType const&>(),
+                std::declval<index_type>()))>;
+        using buffer_type = Kokkos::resilience::util::ScratchView<
+            result_type, typename base_execution_space::memory_space>;
+        using shadow_type = typename buffer_type::view_type;
+
+        using replica_type =
+            Kokkos::resilience::util::ResilientReplicateDiverseFunctor<
+                FunctorType, work_tag, index_type, shadow_type>;
+        using vote_type =
+            Kokkos::resilience::util::ResilientReplicateVoteFunctor<
+                base_execution_space, FunctorType, work_tag, index_type,
+                shadow_type>;
+
+        static_assert(!std::is_same<typename BasePolicy::schedule_type::type,
+                          Kokkos::Dynamic>::value,
+            "ResilientReplicateDiverse requires a static schedule, dynamic "
+            "schedules do not keep the replicas of an index apart.");
+        using base_type =
+            ParallelFor<replica_type, BasePolicy, base_execution_space>;
+
+        ParallelFor(FunctorType const& arg_functor, Policy const& arg_policy)
+          : m_functor(arg_functor)
+          , m_policy(arg_policy)
+        {
+        }
+
+        void execute() const
+        {
+            std::size_t const n = m_policy.end() - m_policy.begin();
+            if (n == 0)
+                return;
+
+            // Shadow buffers are drawn from the scratch arena without
+            // initialization. Arena blocks are reused across launches, so
+            // their pages stay wherever they were first touched and are not
+            // placed in the NUMA domain of the threads writing them.
+            buffer_type const buffers[3] = {
+                buffer_type(n), buffer_type(n), buffer_type(n)};
+            shadow_type shadows[3];
+            std::size_t offsets[3];
+            for (std::size_t r = 0; r != 3; ++r)
+            {
+                shadows[r] = buffers[r].view();
+                offsets[r] = r * (n / 3);
+
+                // Call the underlying ParallelFor
+                replica_type inst(
+                    m_functor, shadows[r], m_policy.begin(), offsets[r]);
+                base_type closure(inst, m_policy);
+                closure.execute();
+            }
+
+            vote_type vote(m_functor, m_policy.begin(), shadows[0],
+                shadows[1], shadows[2], offsets[1], offsets[2]);
+            Kokkos::parallel_for("krs_replicate_vote",
+                Kokkos::RangePolicy<base_execution_space>(
+                    m_policy.space(), 0, n),
+                vote);
+
+            if (vote.is_incorrect())
+                throw std::runtime_error(
+                    "All replicates returned different results.");
+        }
+
+    private:
+        const FunctorType m_functor;
+        const BasePolicy m_policy;
+    };
+
+    template <typename FunctorType, typename... Traits>
+    class ParallelFor<FunctorType, Kokkos::RangePolicy<Traits...>,
+        Kokkos::resilience::ResilientReplicateTiled<
+            typename Kokkos::resilience::traits::RangePolicyExtracter<
+                Traits...>::base_execution_space>>
+    {
+    public:
+        using Policy = Kokkos::RangePolicy<Traits...>;
+        using BasePolicy =
+            typename Kokkos::resilience::traits::RangePolicyExtracter<
+                Traits...>::RangePolicy;
+        using base_execution_space =
+            typename Kokkos::resilience::traits::RangePolicyExtracter<
+                Traits...>::base_execution_space;
+
+        using index_type = typename BasePolicy::index_type;
+        using work_tag = typename BasePolicy::work_tag;
+
+        using tile_type =
+            Kokkos::resilience::util::ResilientReplicateTileFunctor<
+                base_execution_space, FunctorType, work_tag, index_type>;
+        using tile_policy = Kokkos::RangePolicy<base_execution_space,
+            Kokkos::IndexType<index_type>>;
+        using base_type =
+            ParallelFor<tile_type, tile_policy, base_execution_space>;
+
+        ParallelFor(FunctorType const& arg_functor, Policy const& arg_policy)
+          : m_functor(arg_functor)
+          , m_policy(arg_policy)
+        {
+        }
+
+        void execute() const
+        {
+            index_type const n = m_policy.end() - m_policy.begin();
+            index_type const tile = index_type(m_policy.space().tile());
+
+            tile_type inst(
+                m_functor, m_policy.begin(), m_policy.end(), tile);
+
+            // Call the underlying ParallelFor, one iteration per tile
+            base_type closure(
+                inst, tile_policy(m_policy.space(), 0, (n + tile - 1) / tile));
+            closure.execute();
+
+            if (inst.is_incorrect())
+                throw std::runtime_error(
+                    "All replicates returned different results.");
+        }
+
+    private:
+        const FunctorType m_functor;
+        const Policy m_policy;
+    };
+
+    template <typename FunctorType, typename... Traits>
+    class ParallelFor<FunctorType, Kokkos::MDRangePolicy<Traits...>,
+        Kokkos::resilience::ResilientReplicateTiled<
+            typename Kokkos::resilience::traits::MDRangePolicyExtracter<
+                Traits...>::base_execution_space>>
+    {
+    public:
+        using Policy = Kokkos::MDRangePolicy<Traits...>;
+        using base_execution_space =
+            typename Kokkos::resilience::traits::MDRangePolicyExtracter<
+                Traits...>::base_execution_space;
+
+        using point_type = typename Policy::point_type;
+        using work_tag = typename Policy::work_tag;
+
+        using tile_type =
+            Kokkos::resilience::util::ResilientReplicateMDTileFunctor<
+                base_execution_space, FunctorType, work_tag, point_type,
+                Policy::rank>;
+        using tile_policy = Kokkos::RangePolicy<base_execution_space,
+            Kokkos::IndexType<std::size_t>>;
+        using base_type =
+            ParallelFor<tile_type, tile_policy, base_execution_space>;
+
+        ParallelFor(FunctorType const& arg_functor, Policy const& arg_policy)
+          : m_functor(arg_functor)
+          , m_policy(arg_policy)
+        {
+        }
+
+        void execute() const
+        {
+            // Unset tile extents default to the whole innermost dimension
+            // and to 2 points in the others
+            point_type tile;
+            for (int d = 0; d != Policy::rank; ++d)
+            {
+                if (m_policy.m_upper[d] <= m_policy.m_lower[d])
+                    return;
+
+                tile[d] = m_policy.m_tile[d];
+                if (tile[d] <= 0)
+                {
+                    tile[d] = d == Policy::rank - 1 ?
+                        m_policy.m_upper[d] - m_policy.m_lower[d] :
+                        2;
+                }
+            }
+
+            tile_type inst(
+                m_functor, m_policy.m_lower, m_policy.m_upper, tile);
+
+            // Call the underlying ParallelFor, one iteration per tile
+            base_type closure(
+                inst, tile_policy(m_policy.space(), 0, inst.size()));
+            closure.execute();
+
+            if (inst.is_incorrect())
+                throw std::runtime_error(
+                    "All replicates returned different results.");
+        }
+
+    private:
+        const FunctorType m_functor;
+        const Policy m_policy;
+    };
+
+    // Two passes of ResilientShadowReplicate shared by the RangePolicy and
+    // MDRangePolicy specializations below. The first runs the functor and
+    // its shadow on the policy and queues the points where they disagree,
+    // the second replicates only those.
+    template <typename FunctorType, typename Policy, typename BasePolicy,
+        typename Extracter, int Rank>
+    class ShadowReplicateParallelForBase
+    {
+    public:
+        using base_execution_space = typename Extracter::base_execution_space;
+        using shadow_type = typename Extracter::execution_space::shadow_type;
+        using work_tag = typename BasePolicy::work_tag;
+
+        using points_type = Kokkos::resilience::util::PolicyPoints<
+            typename BasePolicy::index_type, Rank>;
+        using queue_type = Kokkos::resilience::util::RetryQueue<
+            base_execution_space, std::size_t>;
+        using check_type =
+            Kokkos::resilience::util::ResilientShadowCheckFunctor<
+                base_execution_space, FunctorType, shadow_type, work_tag,
+                points_type>;
+        using functor_type =
+            Kokkos::resilience::util::ResilientShadowReplicateFunctor<
+                base_execution_space, FunctorType, shadow_type, work_tag,
+                points_type>;
+        using drain_policy = Kokkos::RangePolicy<base_execution_space,
+            Kokkos::Schedule<Kokkos::Dynamic>, Kokkos::IndexType<std::size_t>>;
+
+        void execute() const
+        {
+            std::size_t const size = m_points.size();
+            if (size == 0)
+                return;
+
+            double const relative = m_policy.space().relative();
+            double const absolute = m_policy.space().absolute();
+
+            queue_type const queue(
+                queue_type::default_capacity(size), std::size_t(0), size);
+
+            // Call the underlying ParallelFor
+            check_type check(m_functor, relative, absolute, m_points, queue);
+            ParallelFor<check_type, BasePolicy, base_execution_space> closure(
+                check, m_policy);
+            closure.execute();
+
+            std::size_t const flagged = queue.count();
+            if (flagged == 0)
+                return;
+
+            functor_type inst(m_functor, relative, absolute, m_points, queue,
+                queue.queued(flagged));
+            ParallelFor<functor_type, drain_policy, base_execution_space>
+                replicate(inst,
+                    drain_policy(m_policy.space(), 0, queue.slots(flagged)));
+            replicate.execute();
+
+            if (inst.is_incorrect())
+                throw std::runtime_error(
+                    "Replicates disagreed beyond the shadow error bound.");
+        }
+
+    protected:
+        ShadowReplicateParallelForBase(FunctorType const& arg_functor,
+            Policy const& arg_policy, points_type const& arg_points)
+          : m_functor(arg_functor)
+          , m_policy(arg_policy)
+          , m_points(arg_points)
+        {
+        }
+
+    private:
+        const FunctorType m_functor;
+        const Policy m_policy;
+        const points_type m_points;
+    };
+
+    template <typename FunctorType, typename... Traits>
+    class ParallelFor<FunctorType, Kokkos::RangePolicy<Traits...>,
+        Kokkos::resilience::ResilientShadowReplicate<
+            typename Kokkos::resilience::traits::RangePolicyExtracter<
+                Traits...>::base_execution_space,
+            typename Kokkos::resilience::traits::RangePolicyExtracter<
+                Traits...>::execution_space::shadow_type>>
+      : public ShadowReplicateParallelForBase<FunctorType,
+            Kokkos::RangePolicy<Traits...>,
+            typename Kokkos::resilience::traits::RangePolicyExtracter<
+                Traits...>::RangePolicy,
+            Kokkos::resilience::traits::RangePolicyExtracter<Traits...>, 1>
+    {
+    public:
+        using Policy = Kokkos::RangePolicy<Traits...>;
+        using BasePolicy =
+            typename Kokkos::resilience::traits::RangePolicyExtracter<
+                Traits...>::RangePolicy;
+        using shadow_base = ShadowReplicateParallelForBase<FunctorType,
+            Policy, BasePolicy,
+            Kokkos::resilience::traits::RangePolicyExtracter<Traits...>, 1>;
+
+        ParallelFor(FunctorType const& arg_functor, Policy const& arg_policy)
+          : shadow_base(arg_functor, arg_policy, points(arg_policy))
+        {
+        }
+
+    private:
+        static typename shadow_base::points_type points(Policy const& policy)
+        {
+            typename shadow_base::points_type points;
+            points.lower[0] = policy.begin();
+            points.extent[0] = policy.end() - policy.begin();
+            return points;
+        }
+    };
+
+    template <typename FunctorType, typename... Traits>
+    class ParallelFor<FunctorType, Kokkos::MDRangePolicy<Traits...>,
+        Kokkos::resilience::ResilientShadowReplicate<
+            typename Kokkos::resilience::traits::MDRangePolicyExtracter<
+                Traits...>::base_execution_space,
+            typename Kokkos::resilience::traits::MDRangePolicyExtracter<
+                Traits...>::execution_space::shadow_type>>
+      : public ShadowReplicateParallelForBase<FunctorType,
+            Kokkos::MDRangePolicy<Traits...>,
+            typename Kokkos::resilience::traits::MDRangePolicyExtracter<
+                Traits...>::MDRangePolicy,
+            Kokkos::resilience::traits::MDRangePolicyExtracter<Traits...>,
+            Kokkos::MDRangePolicy<Traits...>::rank>
+    {
+    public:
+        using Policy = Kokkos::MDRangePolicy<Traits...>;
+        using BasePolicy =
+            typename Kokkos::resilience::traits::MDRangePolicyExtracter<
+                Traits...>::MDRangePolicy;
+        using shadow_base = ShadowReplicateParallelForBase<FunctorType,
+            Policy, BasePolicy,
+            Kokkos::resilience::traits::MDRangePolicyExtracter<Traits...>,
+            Policy::rank>;
+
+        ParallelFor(FunctorType const& arg_functor, Policy const& arg_policy)
+          : shadow_base(arg_functor, arg_policy, points(arg_policy))
+        {
+        }
+
+    private:
+        // Empty dimensions leave no points
+        static typename shadow_base::points_type points(Policy const& policy)
+        {
+            typename shadow_base::points_type points;
+            for (int d = 0; d != Policy::rank; ++d)
+            {
+                points.lower[d] = policy.m_lower[d];
+                points.extent[d] = policy.m_upper[d] > policy.m_lower[d] ?
+                    policy.m_upper[d] - policy.m_lower[d] :
+                    0;
+            }
+            return points;
+        }
+    };
+
 }}    // namespace Kokkos::Impl
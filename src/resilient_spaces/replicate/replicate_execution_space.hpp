@@ -8,6 +8,10 @@
 
 #include <Kokkos_Core.hpp>
 
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
 namespace Kokkos { namespace resilience {
 
     template <typename ExecutionSpace, typename Validator>
@@ -81,6 +85,181 @@ namespace Kokkos { namespace resilience {
             ResilientReplicate const& other) = default;
     };
 
+    // Replicates on distinct cores: every replica is a separate pass over the
+    // whole range with the index-to-thread mapping rotated by a third of
+    // the range. With the host threads bound to spread places
+    // (OMP_PROC_BIND=spread, OMP_PLACES=cores) the replicas of an index
+    // then run on different cores and NUMA domains. Host backends only.
+    //
+    // The replicas of an index only run on different threads if the static
+    // schedule gives every thread a contiguous block of at most a third of
+    // the range, i.e. with at least four threads (three if the extent is a
+    // multiple of three), ranges of at least six indices and the default
+    // chunk size. Dynamic schedules are rejected. With fewer threads, e.g.
+    // on Serial, the replicas still vote but share a core.
+    //
+    // The writes of the functor are those of the last replica. Indices
+    // where it is outvoted are evaluated once more after the vote.
+    template <typename ExecutionSpace>
+    class ResilientReplicateDiverse : public ExecutionSpace
+    {
+        static_assert(Kokkos::SpaceAccessibility<Kokkos::HostSpace,
+                          typename ExecutionSpace::memory_space>::accessible,
+            "ResilientReplicateDiverse requires a host execution space.");
+
+    public:
+        // Typedefs for the ResilientReplicateDiverse Execution Space
+        using base_execution_space = ExecutionSpace;
+        using validator_type = void;
+
+        using execution_space = ResilientReplicateDiverse;
+        using memory_space = typename ExecutionSpace::memory_space;
+        using device_type = typename ExecutionSpace::device_type;
+        using size_type = typename ExecutionSpace::size_type;
+        using scratch_memory_space =
+            typename ExecutionSpace::scratch_memory_space;
+
+        static constexpr std::uint64_t replicates = 3;
+
+        template <typename... Args>
+        ResilientReplicateDiverse(Args&&... args) noexcept
+          : ExecutionSpace(args...)
+        {
+        }
+
+        KOKKOS_FUNCTION ResilientReplicateDiverse(
+            ResilientReplicateDiverse&& other) noexcept = default;
+        KOKKOS_FUNCTION ResilientReplicateDiverse(
+            ResilientReplicateDiverse const& other) = default;
+    };
+
+    // Replicates in time per tile: a tile of the iteration space is run
+    // twice back-to-back by the same thread while its inputs are still
+    // cached, and a third time only if the results of the two passes differ.
+    // The results of a pass are compared as one hash over the tile, the
+    // writes of the last pass are kept. RangePolicy is split into tiles of
+    // tile() indices, MDRangePolicy uses the tiles of the policy.
+    template <typename ExecutionSpace>
+    class ResilientReplicateTiled : public ExecutionSpace
+    {
+    public:
+        // Typedefs for the ResilientReplicateTiled Execution Space
+        using base_execution_space = ExecutionSpace;
+        using validator_type = void;
+
+        using execution_space = ResilientReplicateTiled;
+        using memory_space = typename ExecutionSpace::memory_space;
+        using device_type = typename ExecutionSpace::device_type;
+        using size_type = typename ExecutionSpace::size_type;
+        using scratch_memory_space =
+            typename ExecutionSpace::scratch_memory_space;
+
+        static constexpr std::size_t default_tile = 256;
+
+        template <typename... Args>
+        ResilientReplicateTiled(std::size_t tile, Args&&... args) noexcept
+          : ExecutionSpace(args...)
+          , tile_(tile == 0 ? default_tile : tile)
+        {
+        }
+
+        ResilientReplicateTiled() noexcept
+          : tile_(default_tile)
+        {
+        }
+
+        std::size_t tile() const noexcept
+        {
+            return tile_;
+        }
+
+        KOKKOS_FUNCTION ResilientReplicateTiled(
+            ResilientReplicateTiled&& other) noexcept = default;
+        KOKKOS_FUNCTION ResilientReplicateTiled(
+            ResilientReplicateTiled const& other) = default;
+
+    private:
+        const std::size_t tile_;
+    };
+
+    // Checks a kernel with a replica in lower precision. The functor runs
+    // as given and as Functor::rebind<Shadow>, constructed from the
+    // functor. Results agreeing within a relative and absolute error bound
+    // are accepted. Otherwise the functor runs again, and its two results
+    // must agree bitwise or the second one must agree with the shadow.
+    //
+    // The shadow replica runs first and must not write to Views read by
+    // the kernel; typically it only returns its result. The roundoff of the
+    // shadow scales with its inputs, not with results near zero after
+    // cancellation, so the bound has an absolute term as well. The default
+    // bound is default_ulps units of roundoff of Shadow relative to the
+    // results plus the same absolute term for inputs of magnitude one,
+    // absolute_bound gives it for other magnitudes.
+    template <typename ExecutionSpace, typename Shadow = float>
+    class ResilientShadowReplicate : public ExecutionSpace
+    {
+    public:
+        // Typedefs for the ResilientShadowReplicate Execution Space
+        using base_execution_space = ExecutionSpace;
+        using validator_type = void;
+        using shadow_type = Shadow;
+
+        using execution_space = ResilientShadowReplicate;
+        using memory_space = typename ExecutionSpace::memory_space;
+        using device_type = typename ExecutionSpace::device_type;
+        using size_type = typename ExecutionSpace::size_type;
+        using scratch_memory_space =
+            typename ExecutionSpace::scratch_memory_space;
+
+        static constexpr double default_ulps = 16.;
+
+        template <typename... Args>
+        ResilientShadowReplicate(
+            double relative, double absolute, Args&&... args) noexcept
+          : ExecutionSpace(args...)
+          , relative_(relative)
+          , absolute_(absolute)
+        {
+        }
+
+        ResilientShadowReplicate() noexcept
+          : relative_(relative_bound())
+          , absolute_(absolute_bound(1.))
+        {
+        }
+
+        static constexpr double relative_bound() noexcept
+        {
+            return default_ulps * std::numeric_limits<Shadow>::epsilon();
+        }
+
+        // Absolute term of the default bound for inputs of the given
+        // magnitude
+        static constexpr double absolute_bound(double magnitude) noexcept
+        {
+            return relative_bound() * magnitude;
+        }
+
+        double relative() const noexcept
+        {
+            return relative_;
+        }
+
+        double absolute() const noexcept
+        {
+            return absolute_;
+        }
+
+        KOKKOS_FUNCTION ResilientShadowReplicate(
+            ResilientShadowReplicate&& other) noexcept = default;
+        KOKKOS_FUNCTION ResilientShadowReplicate(
+            ResilientShadowReplicate const& other) = default;
+
+    private:
+        const double relative_;
+        const double absolute_;
+    };
+
 }}    // namespace Kokkos::resilience
 
 namespace Kokkos { namespace Tools { namespace Experimental {
@@ -92,6 +271,27 @@ namespace Kokkos { namespace Tools { namespace Experimental {
         static constexpr DeviceType id = DeviceTypeTraits<ExecutionSpace>::id;
     };
 
+    template <typename ExecutionSpace>
+    struct DeviceTypeTraits<
+        Kokkos::resilience::ResilientReplicateDiverse<ExecutionSpace>>
+    {
+        static constexpr DeviceType id = DeviceTypeTraits<ExecutionSpace>::id;
+    };
+
+    template <typename ExecutionSpace>
+    struct DeviceTypeTraits<
+        Kokkos::resilience::ResilientReplicateTiled<ExecutionSpace>>
+    {
+        static constexpr DeviceType id = DeviceTypeTraits<ExecutionSpace>::id;
+    };
+
+    template <typename ExecutionSpace, typename Shadow>
+    struct DeviceTypeTraits<
+        Kokkos::resilience::ResilientShadowReplicate<ExecutionSpace, Shadow>>
+    {
+        static constexpr DeviceType id = DeviceTypeTraits<ExecutionSpace>::id;
+    };
+
     template <typename ExecutionSpace, typename Validator>
     struct DeviceTypeTraits<Kokkos::resilience::ResilientReplicateValidate<
         ExecutionSpace, Validator>>
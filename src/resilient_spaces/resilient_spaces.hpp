@@ -6,9 +6,25 @@
 
 #pragma once
 
+#include <resilient_spaces/checkpoint/checkpoint.hpp>
+#include <resilient_spaces/dynamic/dynamic_execution_space.hpp>
+#include <resilient_spaces/dynamic/parallel_for.hpp>
+#include <resilient_spaces/ecc/ecc_view.hpp>
+
 #include <resilient_spaces/replay/parallel_for.hpp>
 #include <resilient_spaces/replay/parallel_reduce.hpp>
 #include <resilient_spaces/replay/replay_execution_space.hpp>
+#include <resilient_spaces/replay/speculation.hpp>
+#include <resilient_spaces/replay/transaction.hpp>
 
 #include <resilient_spaces/replicate/parallel_for.hpp>
 #include <resilient_spaces/replicate/replicate_execution_space.hpp>
+
+#include <resilient_spaces/scrub/scrubber.hpp>
+#include <resilient_spaces/snapshot/dirty_page_tracker.hpp>
+
+#include <resilient_spaces/util/accumulator.hpp>
+#include <resilient_spaces/util/captured_view.hpp>
+#include <resilient_spaces/util/launch_plan.hpp>
+#include <resilient_spaces/util/validators.hpp>
+#include <resilient_spaces/util/vote.hpp>
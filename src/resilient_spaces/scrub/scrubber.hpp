@@ -0,0 +1,469 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <Kokkos_Core.hpp>
+
+#include <resilient_spaces/checkpoint/checkpoint.hpp>
+#include <resilient_spaces/util/hash.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Background scrubbing of long-lived Views.
+//
+// Registered Views are split into blocks of block_values values with one
+// checksum each. A host thread verifies the blocks round-robin, throttled to
+// a number of bytes per second, and reports corrupted blocks to a callback.
+// Views registered with a checkpoint file (of the same block size) have the
+// corrupted block restored from it, if the checkpointed block matches its
+// checksum.
+//
+// Writers must pause the scrubber while kernels modify registered Views and
+// mark the modified values with touch() before resuming, resume() refreshes
+// the checksums of the touched blocks only. The resilient kernels do not
+// touch the Views they write themselves, as kernels do not declare which
+// Views they write. The scrubber can be enlisted in a ResilientTransaction,
+// which pauses it for the group and resumes it once the group is validated.
+namespace Kokkos { namespace resilience {
+
+    struct ScrubEvent
+    {
+        std::string label;
+        std::size_t block;
+        bool restored;
+
+        // Why the block could not be verified or restored, e.g. a missing
+        // or truncated checkpoint. Empty otherwise.
+        std::string error;
+    };
+
+    struct ScrubStatistics
+    {
+        std::size_t verified_blocks = 0;
+        std::size_t corrupted_blocks = 0;
+        std::size_t restored_blocks = 0;
+    };
+
+    class Scrubber
+    {
+    public:
+        using callback_type = std::function<void(ScrubEvent const&)>;
+
+        // A rate of zero starts no thread, blocks are then only verified by
+        // scrub().
+        explicit Scrubber(std::size_t bytes_per_second,
+            std::size_t block_values = checkpoint::default_block_values)
+          : rate_(bytes_per_second)
+          , block_values_(block_values)
+        {
+            if (block_values_ == 0)
+                throw std::runtime_error("Scrub blocks must not be empty.");
+
+            if (rate_ != 0)
+                thread_ = std::thread([this] { run(); });
+        }
+
+        Scrubber(Scrubber const&) = delete;
+        Scrubber& operator=(Scrubber const&) = delete;
+
+        ~Scrubber()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+            wake_.notify_all();
+
+            if (thread_.joinable())
+                thread_.join();
+        }
+
+        // Host accessible, contiguous Views only. The View must outlive the
+        // scrubber or be removed.
+        template <typename ViewType>
+        void add(ViewType const& view)
+        {
+            add_entry(view, {});
+        }
+
+        // Corrupted blocks are restored from the checkpoint at path. The
+        // block is decoded into a buffer and only copied into the View if
+        // it matches the checksum of the block.
+        template <typename ViewType>
+        void add(ViewType const& view, std::string const& path)
+        {
+            using value_type = typename ViewType::non_const_value_type;
+
+            checkpoint::detail::check_view(view);
+
+            add_entry(view,
+                [path, view](std::size_t block, std::uint64_t expected) {
+                    std::vector<value_type> values;
+                    std::size_t const offset =
+                        checkpoint::detail::read_block_values(
+                            path, view.span(), block, values);
+
+                    std::size_t const bytes =
+                        values.size() * sizeof(value_type);
+                    if (checksum(reinterpret_cast<unsigned char const*>(
+                                     values.data()),
+                            bytes) != expected)
+                        return false;
+
+                    std::memcpy(view.data() + offset, values.data(), bytes);
+                    return true;
+                });
+        }
+
+        template <typename ViewType>
+        void remove(ViewType const& view)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            entries_.erase(find(view.data()));
+            cursor_ = {};
+        }
+
+        // Called from the scrubbing thread, without the scrubber locked.
+        void on_corruption(callback_type callback)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            callback_ = std::move(callback);
+        }
+
+        // Suspends verification, pauses nest.
+        void pause()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++paused_;
+        }
+
+        // Marks values [first, last) of a registered View as rewritten.
+        template <typename ViewType>
+        void touch(ViewType const& view, std::size_t first, std::size_t last)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            entry& e = *find(view.data());
+            std::size_t const value_bytes = e.block_bytes / block_values_;
+
+            last = (std::min)(last * value_bytes, e.bytes);
+            for (std::size_t b = first * value_bytes / e.block_bytes;
+                 b * e.block_bytes < last; ++b)
+                e.dirty[b] = true;
+        }
+
+        template <typename ViewType>
+        void touch(ViewType const& view)
+        {
+            touch(view, 0, view.span());
+        }
+
+        // Waits for the writing kernels, refreshes the checksums of the
+        // touched blocks and resumes verification.
+        void resume()
+        {
+            Kokkos::fence();
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                for (entry& e : entries_)
+                {
+                    for (std::size_t b = 0; b != e.dirty.size(); ++b)
+                    {
+                        if (e.dirty[b])
+                            e.checksums[b] = checksum(e, b);
+                        e.dirty[b] = false;
+                    }
+                }
+
+                if (paused_ != 0)
+                    --paused_;
+            }
+            wake_.notify_all();
+        }
+
+        // ResilientTransaction participant
+        void save()
+        {
+            pause();
+        }
+
+        void restore() {}
+
+        void commit()
+        {
+            resume();
+        }
+
+        // Verifies all blocks on the calling thread, registered Views must
+        // not be written meanwhile. Returns the number of corrupted blocks,
+        // throws if a checkpoint cannot be read.
+        std::size_t scrub()
+        {
+            std::size_t corrupted = 0;
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            for (std::size_t i = 0; i != entries_.size(); ++i)
+            {
+                for (std::size_t b = 0; b != entries_[i].checksums.size();
+                     ++b)
+                {
+                    corrupted += !verify(lock, i, b);
+                }
+            }
+            return corrupted;
+        }
+
+        ScrubStatistics statistics() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return statistics_;
+        }
+
+    private:
+        struct entry
+        {
+            std::string label;
+            unsigned char const* data;
+            std::size_t bytes;
+            std::size_t block_bytes;
+            std::vector<std::uint64_t> checksums;
+            std::vector<bool> dirty;
+            std::function<bool(std::size_t, std::uint64_t)> restore;
+        };
+
+        struct position
+        {
+            std::size_t entry = 0;
+            std::size_t block = 0;
+        };
+
+        // restore(block, checksum) restores a block if the replacement
+        // matches the checksum, and returns whether it did.
+        template <typename ViewType>
+        void add_entry(ViewType const& view,
+            std::function<bool(std::size_t, std::uint64_t)> restore)
+        {
+            static_assert(
+                Kokkos::SpaceAccessibility<Kokkos::HostSpace,
+                    typename ViewType::memory_space>::accessible,
+                "Scrubbed Views must be host accessible.");
+
+            if (!view.span_is_contiguous())
+                throw std::runtime_error(
+                    "Scrubbing requires a contiguous View.");
+
+            using value_type = typename ViewType::non_const_value_type;
+
+            entry e;
+            e.label = view.label();
+            e.data = reinterpret_cast<unsigned char const*>(view.data());
+            e.bytes = view.span() * sizeof(value_type);
+            e.block_bytes = block_values_ * sizeof(value_type);
+            e.restore = std::move(restore);
+
+            std::size_t const blocks =
+                (e.bytes + e.block_bytes - 1) / e.block_bytes;
+            if (blocks == 0)
+                return;
+            e.dirty.assign(blocks, false);
+
+            Kokkos::fence();
+            for (std::size_t b = 0; b != blocks; ++b)
+                e.checksums.push_back(checksum(e, b));
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            entries_.push_back(std::move(e));
+            wake_.notify_all();
+        }
+
+        std::vector<entry>::iterator find(void const* data)
+        {
+            auto const it = std::find_if(entries_.begin(), entries_.end(),
+                [data](entry const& e) { return e.data == data; });
+
+            if (it == entries_.end())
+                throw std::runtime_error("View is not scrubbed.");
+            return it;
+        }
+
+        static std::uint64_t checksum(entry const& e, std::size_t block)
+        {
+            std::size_t const first = block * e.block_bytes;
+            std::size_t const last = (std::min)(first + e.block_bytes, e.bytes);
+
+            return checksum(e.data + first, last - first);
+        }
+
+        static std::uint64_t checksum(
+            unsigned char const* data, std::size_t bytes)
+        {
+            std::uint64_t hash = bytes;
+            std::size_t k = 0;
+            for (; k + 8 <= bytes; k += 8)
+            {
+                std::uint64_t word;
+                std::memcpy(&word, data + k, 8);
+                hash = util::mix(hash ^ word);
+            }
+
+            std::uint64_t word = 0;
+            std::memcpy(&word, data + k, bytes - k);
+            return util::mix(hash ^ word);
+        }
+
+        // Verifies a block, restoring it if possible. The callback is run
+        // with the lock released.
+        bool verify(std::unique_lock<std::mutex>& lock, std::size_t i,
+            std::size_t block)
+        {
+            entry& e = entries_[i];
+            ++statistics_.verified_blocks;
+
+            if (checksum(e, block) == e.checksums[block])
+                return true;
+
+            ++statistics_.corrupted_blocks;
+
+            bool restored = false;
+            if (e.restore)
+            {
+                restored = e.restore(block, e.checksums[block]);
+                statistics_.restored_blocks += restored;
+            }
+
+            notify(lock, ScrubEvent{e.label, block, restored, {}});
+
+            return false;
+        }
+
+        // Runs the callback with the lock released
+        void notify(std::unique_lock<std::mutex>& lock, ScrubEvent const& event)
+        {
+            if (!callback_)
+                return;
+
+            callback_type const callback = callback_;
+
+            lock.unlock();
+            try
+            {
+                callback(event);
+            }
+            catch (...)
+            {
+                lock.lock();
+                throw;
+            }
+            lock.lock();
+        }
+
+        void run()
+        {
+            using clock = std::chrono::steady_clock;
+
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            auto start = clock::now();
+            std::size_t scrubbed = 0;
+
+            while (!stop_)
+            {
+                if (paused_ != 0 || entries_.empty())
+                {
+                    wake_.wait(lock);
+
+                    // Idle time is not credited to the budget
+                    start = clock::now();
+                    scrubbed = 0;
+                    continue;
+                }
+
+                if (cursor_.entry >= entries_.size())
+                    cursor_ = {};
+
+                position const current = cursor_;
+                std::size_t const blocks =
+                    entries_[current.entry].checksums.size();
+                if (++cursor_.block == blocks)
+                    cursor_ = {current.entry + 1, 0};
+
+                scrubbed += entries_[current.entry].block_bytes;
+                std::string const label = entries_[current.entry].label;
+
+                // Exceptions must not escape the thread, failures to read a
+                // checkpoint are reported through the callback instead
+                try
+                {
+                    verify(lock, current.entry, current.block);
+                }
+                catch (std::exception const& error)
+                {
+                    report(lock,
+                        ScrubEvent{label, current.block, false, error.what()});
+                }
+                catch (...)
+                {
+                    report(lock,
+                        ScrubEvent{label, current.block, false,
+                            "Unknown error."});
+                }
+
+                // Throttle to the rate
+                auto const due = start +
+                    std::chrono::duration_cast<clock::duration>(
+                        std::chrono::duration<double>(
+                            double(scrubbed) / double(rate_)));
+                wake_.wait_until(lock, due, [this] { return stop_; });
+            }
+        }
+
+        // Reports a failure from the scrubbing thread, exceptions thrown by
+        // the callback itself are dropped
+        void report(std::unique_lock<std::mutex>& lock, ScrubEvent const& event)
+        {
+            try
+            {
+                notify(lock, event);
+            }
+            catch (...)
+            {
+            }
+        }
+
+        std::size_t const rate_;
+        std::size_t const block_values_;
+
+        mutable std::mutex mutex_;
+        std::condition_variable wake_;
+
+        std::vector<entry> entries_;
+        position cursor_;
+        std::size_t paused_ = 0;
+        bool stop_ = false;
+
+        callback_type callback_;
+        ScrubStatistics statistics_;
+
+        std::thread thread_;
+    };
+
+}}    // namespace Kokkos::resilience
@@ -0,0 +1,441 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <Kokkos_Core.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#if defined(__linux__)
+#include <csignal>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Copy-on-write snapshots of host Views.
+//
+// Registered Views are write-protected when a snapshot begins. The first write
+// to a protected page raises SIGSEGV, the handler saves the page's pre-image
+// and unprotects it, so the cost of a snapshot is proportional to the number
+// of pages written rather than to the size of the Views. Rolling back copies
+// the saved pre-images over the modified pages.
+//
+// Registered memory must not be written by the operating system (read(2),
+// MPI receives, ...) while a snapshot is active, such writes fail instead of
+// raising a signal.
+namespace Kokkos { namespace resilience { namespace snapshot {
+
+    namespace detail {
+
+        enum page_state : unsigned char
+        {
+            clean = 0,
+            capturing = 1,
+            dirty = 2
+        };
+
+        // Regions live in their own anonymous mappings: the fault handler
+        // writes to them and they must never share a page with registered
+        // (write-protected) heap memory.
+        struct region
+        {
+            std::uintptr_t base;     // page aligned
+            std::size_t pages;
+            std::uintptr_t first;    // registered bytes [first, last)
+            std::uintptr_t last;
+            unsigned char* shadow;
+            std::atomic<unsigned char>* state;
+            std::atomic<bool> armed;
+        };
+
+        constexpr std::size_t max_regions = 256;
+
+        inline std::atomic<region*> registry[max_regions];
+
+#if defined(__linux__)
+        inline struct sigaction previous_action = {};
+
+        inline std::size_t page_size() noexcept
+        {
+            static std::size_t const size = sysconf(_SC_PAGESIZE);
+            return size;
+        }
+
+        inline void forward_signal(int sig, siginfo_t* info, void* context)
+        {
+            if (previous_action.sa_flags & SA_SIGINFO)
+            {
+                previous_action.sa_sigaction(sig, info, context);
+                return;
+            }
+
+            if (previous_action.sa_handler == SIG_IGN)
+                return;
+
+            if (previous_action.sa_handler == SIG_DFL)
+            {
+                signal(sig, SIG_DFL);
+                raise(sig);
+                return;
+            }
+
+            previous_action.sa_handler(sig);
+        }
+
+        // Only async-signal-safe operations are allowed in here.
+        inline void handle_fault(int sig, siginfo_t* info, void* context)
+        {
+            std::size_t const size = page_size();
+            std::uintptr_t const addr =
+                reinterpret_cast<std::uintptr_t>(info->si_addr);
+            std::uintptr_t const page_addr = addr & ~(size - 1);
+
+            region* captured[max_regions];
+            std::size_t count = 0;
+            bool handled = false;
+
+            // Save the pre-image in every region sharing the page before any
+            // of them makes it writable again.
+            for (auto& slot : registry)
+            {
+                region* r = slot.load(std::memory_order_acquire);
+                if (r == nullptr || !r->armed.load(std::memory_order_acquire))
+                    continue;
+
+                if (page_addr < r->base ||
+                    page_addr >= r->base + r->pages * size)
+                    continue;
+
+                handled = true;
+
+                std::size_t const page = (page_addr - r->base) / size;
+                unsigned char expected = clean;
+                if (r->state[page].compare_exchange_strong(expected, capturing,
+                        std::memory_order_acq_rel))
+                {
+                    std::memcpy(r->shadow + page * size,
+                        reinterpret_cast<void const*>(page_addr), size);
+                    captured[count++] = r;
+                }
+            }
+
+            if (!handled)
+            {
+                forward_signal(sig, info, context);
+                return;
+            }
+
+            if (count != 0)
+            {
+                mprotect(reinterpret_cast<void*>(page_addr), size,
+                    PROT_READ | PROT_WRITE);
+
+                for (std::size_t i = 0; i != count; ++i)
+                {
+                    std::size_t const page =
+                        (page_addr - captured[i]->base) / size;
+                    captured[i]->state[page].store(
+                        dirty, std::memory_order_release);
+                }
+            }
+
+            // Another thread is capturing the page, retry the write once
+            // it is done.
+            for (auto& slot : registry)
+            {
+                region* r = slot.load(std::memory_order_acquire);
+                if (r == nullptr || page_addr < r->base ||
+                    page_addr >= r->base + r->pages * size)
+                    continue;
+
+                std::size_t const page = (page_addr - r->base) / size;
+                while (r->state[page].load(std::memory_order_acquire) ==
+                    capturing)
+                {
+                }
+            }
+        }
+
+        inline void install_handler()
+        {
+            static std::once_flag installed;
+            std::call_once(installed, [] {
+                struct sigaction action = {};
+                action.sa_sigaction = &handle_fault;
+                action.sa_flags = SA_SIGINFO | SA_RESTART;
+                sigemptyset(&action.sa_mask);
+
+                if (sigaction(SIGSEGV, &action, &previous_action) != 0)
+                    throw std::runtime_error(
+                        "Unable to install the dirty page fault handler.");
+            });
+        }
+#endif
+
+    }    // namespace detail
+
+    class DirtyPageTracker
+    {
+    public:
+        DirtyPageTracker()
+        {
+#if defined(__linux__)
+            detail::install_handler();
+#else
+            throw std::runtime_error("Dirty page tracking requires Linux.");
+#endif
+        }
+
+        ~DirtyPageTracker()
+        {
+            commit();
+
+#if defined(__linux__)
+            for (detail::region* r : regions_)
+            {
+                for (auto& slot : detail::registry)
+                {
+                    detail::region* expected = r;
+                    slot.compare_exchange_strong(expected, nullptr);
+                }
+                munmap(r->shadow, r->pages * detail::page_size());
+                munmap(r, metadata_bytes(r->pages));
+            }
+#endif
+        }
+
+        DirtyPageTracker(DirtyPageTracker const&) = delete;
+        DirtyPageTracker& operator=(DirtyPageTracker const&) = delete;
+
+        // Registers the memory of a host View. Must not be called while a
+        // snapshot is active.
+        template <typename ViewType>
+        void register_view(ViewType const& view)
+        {
+            static_assert(std::is_same<typename ViewType::memory_space,
+                              Kokkos::HostSpace>::value,
+                "Dirty page tracking is only supported for HostSpace Views.");
+
+            if (!view.span_is_contiguous())
+                throw std::runtime_error(
+                    "Dirty page tracking requires a contiguous View.");
+
+            register_memory(view.data(),
+                view.span() * sizeof(typename ViewType::value_type));
+        }
+
+        // Write-protects all registered memory.
+        void begin()
+        {
+#if defined(__linux__)
+            for (detail::region* r : regions_)
+            {
+                for (std::size_t p = 0; p != r->pages; ++p)
+                    r->state[p].store(detail::clean, std::memory_order_relaxed);
+
+                r->armed.store(true, std::memory_order_release);
+                protect(r->base, r->pages, PROT_READ);
+            }
+            active_ = true;
+#endif
+        }
+
+        // Restores every page written since begin() and write-protects them
+        // again, the snapshot stays active. No kernel may be running.
+        void rollback()
+        {
+#if defined(__linux__)
+            if (!active_)
+                return;
+
+            std::size_t const size = detail::page_size();
+            for (detail::region* r : regions_)
+            {
+                for (std::size_t p = 0; p != r->pages; ++p)
+                {
+                    if (r->state[p].load(std::memory_order_acquire) !=
+                        detail::dirty)
+                        continue;
+
+                    // Only restore registered bytes, the page may be shared
+                    // with unrelated allocations.
+                    std::uintptr_t const page = r->base + p * size;
+                    std::uintptr_t const first = std::max(page, r->first);
+                    std::uintptr_t const last = std::min(page + size, r->last);
+
+                    std::memcpy(reinterpret_cast<void*>(first),
+                        r->shadow + (first - r->base), last - first);
+
+                    protect(page, 1, PROT_READ);
+                    r->state[p].store(detail::clean, std::memory_order_release);
+                }
+            }
+#endif
+        }
+
+        // Drops all saved pre-images and removes the write protection.
+        void commit()
+        {
+#if defined(__linux__)
+            if (!active_)
+                return;
+
+            for (detail::region* r : regions_)
+            {
+                r->armed.store(false, std::memory_order_release);
+                protect(r->base, r->pages, PROT_READ | PROT_WRITE);
+                madvise(r->shadow, r->pages * detail::page_size(),
+                    MADV_DONTNEED);
+            }
+            active_ = false;
+#endif
+        }
+
+        // Number of pages written since begin().
+        std::size_t dirty_pages() const
+        {
+            std::size_t count = 0;
+            for (detail::region const* r : regions_)
+            {
+                for (std::size_t p = 0; p != r->pages; ++p)
+                {
+                    if (r->state[p].load(std::memory_order_acquire) ==
+                        detail::dirty)
+                        ++count;
+                }
+            }
+            return count;
+        }
+
+        bool active() const noexcept
+        {
+            return active_;
+        }
+
+    private:
+        void register_memory(void const* data, std::size_t bytes)
+        {
+#if defined(__linux__)
+            if (active_)
+                throw std::runtime_error(
+                    "Cannot register memory while a snapshot is active.");
+
+            if (bytes == 0)
+                return;
+
+            std::size_t const size = detail::page_size();
+            std::uintptr_t const first = reinterpret_cast<std::uintptr_t>(data);
+            std::uintptr_t const last = first + bytes;
+            std::uintptr_t const base = first & ~(size - 1);
+            std::size_t const pages = (last - base + size - 1) / size;
+
+            // Anonymous mappings are only backed once touched, so the shadow
+            // only costs memory for pages that are actually written.
+            void* shadow = map(pages * size);
+            void* metadata = map(metadata_bytes(pages));
+
+            auto r = new (metadata) detail::region;
+            r->base = base;
+            r->pages = pages;
+            r->first = first;
+            r->last = last;
+            r->shadow = static_cast<unsigned char*>(shadow);
+            r->state = new (r + 1) std::atomic<unsigned char>[pages];
+            for (std::size_t p = 0; p != pages; ++p)
+                r->state[p].store(detail::clean, std::memory_order_relaxed);
+            r->armed.store(false, std::memory_order_relaxed);
+
+            regions_.reserve(regions_.size() + 1);
+            for (auto& slot : detail::registry)
+            {
+                detail::region* expected = nullptr;
+                if (slot.compare_exchange_strong(expected, r))
+                {
+                    regions_.push_back(r);
+                    return;
+                }
+            }
+
+            munmap(shadow, pages * size);
+            munmap(metadata, metadata_bytes(pages));
+            throw std::runtime_error("Too many dirty page tracked regions.");
+#else
+            (void) data;
+            (void) bytes;
+#endif
+        }
+
+#if defined(__linux__)
+        static std::size_t metadata_bytes(std::size_t pages) noexcept
+        {
+            return sizeof(detail::region) +
+                pages * sizeof(std::atomic<unsigned char>);
+        }
+
+        static void* map(std::size_t bytes)
+        {
+            void* ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (ptr == MAP_FAILED)
+                throw std::runtime_error(
+                    "Unable to allocate dirty page tracking memory.");
+            return ptr;
+        }
+
+        static void protect(std::uintptr_t base, std::size_t pages, int prot)
+        {
+            if (mprotect(reinterpret_cast<void*>(base),
+                    pages * detail::page_size(), prot) != 0)
+                throw std::runtime_error("Unable to change page protection.");
+        }
+#endif
+
+        std::vector<detail::region*> regions_;
+        bool active_ = false;
+    };
+
+    // Begins a snapshot on construction and commits it on destruction, a
+    // null tracker turns every operation into a no-op.
+    class ScopedSnapshot
+    {
+    public:
+        explicit ScopedSnapshot(DirtyPageTracker* tracker)
+          : tracker_(tracker)
+        {
+            if (tracker_ != nullptr)
+                tracker_->begin();
+        }
+
+        ~ScopedSnapshot()
+        {
+            if (tracker_ != nullptr)
+                tracker_->commit();
+        }
+
+        ScopedSnapshot(ScopedSnapshot const&) = delete;
+        ScopedSnapshot& operator=(ScopedSnapshot const&) = delete;
+
+        void rollback()
+        {
+            if (tracker_ != nullptr)
+                tracker_->rollback();
+        }
+
+    private:
+        DirtyPageTracker* tracker_;
+    };
+
+}}}    // namespace Kokkos::resilience::snapshot
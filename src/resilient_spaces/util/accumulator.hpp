@@ -0,0 +1,125 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <Kokkos_Core.hpp>
+#include <Kokkos_ScatterView.hpp>
+
+#include <string>
+
+namespace Kokkos { namespace resilience { namespace util {
+
+    // Replay-safe scalar accumulator.
+    //
+    // Contributions made with add() go to ScatterView partials with the
+    // default strategy of the execution space: duplicated per unique token
+    // on threaded host backends, instead of a single contended atomic, and
+    // atomic on device backends, where taking a unique token for every
+    // contribution costs more than the atomic it avoids. Contributions stay
+    // pending until commit() folds them into the committed value, and
+    // restore() discards them.
+    //
+    // The accumulator is a ResilientTransaction participant: enlisted in a
+    // transaction, contributions of a rejected attempt are dropped before the
+    // group is replayed. Kernels launched directly on ResilientReplay or
+    // ResilientReplicate rerun single indices, whose contributions cannot be
+    // told apart from the others, so they must not use it; launch them in
+    // a transaction instead.
+    template <typename T,
+        typename ExecutionSpace = Kokkos::DefaultExecutionSpace>
+    class Accumulator
+    {
+    public:
+        using value_type = T;
+        using execution_space = ExecutionSpace;
+        using memory_space = typename ExecutionSpace::memory_space;
+        using view_type = Kokkos::View<T*, memory_space>;
+        using scatter_type = Kokkos::Experimental::ScatterView<T*,
+            typename view_type::array_layout, ExecutionSpace,
+            Kokkos::Experimental::ScatterSum>;
+
+        explicit Accumulator(std::string const& label,
+            ExecutionSpace const& space = ExecutionSpace{})
+          : space_(space)
+          , committed_(label, 1)
+          , pending_(label + "_pending", 1)
+          , partials_(pending_)
+        {
+        }
+
+        KOKKOS_FUNCTION void add(T const& value) const
+        {
+            auto access = partials_.access();
+            access(0) += value;
+        }
+
+        // Committed value plus pending contributions, fences the space.
+        T value() const
+        {
+            combine();
+
+            T committed{}, pending{};
+            Kokkos::deep_copy(committed, Kokkos::subview(committed_, 0));
+            Kokkos::deep_copy(pending, Kokkos::subview(pending_, 0));
+            return committed + pending;
+        }
+
+        // Replaces the committed value and discards pending contributions.
+        void set(T const& value)
+        {
+            Kokkos::deep_copy(space_, Kokkos::subview(committed_, 0), value);
+            discard();
+        }
+
+        // Transaction participant hooks
+        void save()
+        {
+            commit();
+        }
+
+        void restore()
+        {
+            discard();
+        }
+
+        void commit()
+        {
+            combine();
+
+            view_type committed = committed_;
+            view_type pending = pending_;
+            Kokkos::parallel_for("krs_accumulator_commit",
+                Kokkos::RangePolicy<ExecutionSpace>(space_, 0, 1),
+                KOKKOS_LAMBDA(int) { committed(0) += pending(0); });
+
+            discard();
+        }
+
+    private:
+        // Folds the partials into the pending value
+        void combine() const
+        {
+            space_.fence();
+            partials_.contribute_into(space_, pending_);
+            partials_.reset_except(space_, pending_);
+            space_.fence();
+        }
+
+        void discard()
+        {
+            Kokkos::deep_copy(space_, pending_, T{});
+            partials_.reset_except(space_, pending_);
+            space_.fence();
+        }
+
+        ExecutionSpace space_;
+        view_type committed_;
+        view_type pending_;
+        mutable scatter_type partials_;
+    };
+
+}}}    // namespace Kokkos::resilience::util
@@ -0,0 +1,173 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <Kokkos_Core.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+namespace Kokkos { namespace resilience { namespace util {
+
+    // Elements accessed by one replica of one iteration. The first access
+    // to an element records its value, later accesses of the replica see
+    // the recorded copy, which takes the writes. Elements are written back
+    // by commit() only if their value changed.
+    class WriteLog
+    {
+    public:
+        // Distinct elements an iteration may access through captured Views
+        static constexpr std::size_t capacity = 32;
+
+        template <typename T>
+        T& record(T& element)
+        {
+            static_assert(sizeof(T) <= sizeof(std::uint64_t) &&
+                    std::is_trivially_copyable<T>::value,
+                "Captured Views hold trivially copyable values of at most "
+                "8 bytes.");
+
+            void* const address = &element;
+            for (std::size_t k = 0; k != count_; ++k)
+            {
+                if (entries_[k].address == address)
+                    return value<T>(entries_[k]);
+            }
+
+            // Further accesses of an overflowing iteration go to the spare
+            // entry, the iteration is reported and not committed.
+            entry& e = entries_[count_ == capacity ? capacity : count_++];
+            overflow_ = overflow_ || &e == &entries_[capacity];
+
+            e.address = address;
+            e.size = sizeof(T);
+            std::memcpy(&e.original, &element, sizeof(T));
+            ::new (static_cast<void*>(&e.value)) T(element);
+            return value<T>(e);
+        }
+
+        bool overflow() const noexcept
+        {
+            return overflow_;
+        }
+
+        // Same elements accessed in the same order with the same results
+        bool operator==(WriteLog const& other) const noexcept
+        {
+            if (count_ != other.count_)
+                return false;
+
+            for (std::size_t k = 0; k != count_; ++k)
+            {
+                entry const& a = entries_[k];
+                entry const& b = other.entries_[k];
+                if (a.address != b.address ||
+                    std::memcmp(&a.value, &b.value, a.size) != 0)
+                    return false;
+            }
+            return true;
+        }
+
+        void commit() const noexcept
+        {
+            for (std::size_t k = 0; k != count_; ++k)
+            {
+                entry const& e = entries_[k];
+                if (std::memcmp(&e.value, &e.original, e.size) != 0)
+                    std::memcpy(e.address, &e.value, e.size);
+            }
+        }
+
+    private:
+        struct entry
+        {
+            void* address;
+            std::size_t size;
+            std::uint64_t original;
+            std::uint64_t value;
+        };
+
+        template <typename T>
+        static T& value(entry& e) noexcept
+        {
+            return *std::launder(reinterpret_cast<T*>(&e.value));
+        }
+
+        entry entries_[capacity + 1];
+        std::size_t count_ = 0;
+        bool overflow_ = false;
+    };
+
+    // Log of the replica running on this thread, null outside replicas.
+    inline WriteLog*& current_write_log() noexcept
+    {
+        thread_local WriteLog* log = nullptr;
+        return log;
+    }
+
+    // View whose element accesses are captured while a void functor is
+    // replicated by ResilientReplicate: each replica works on its own copy
+    // of the accessed elements, and the library writes back the elements
+    // of a replica that agrees with another one. Only the elements touched
+    // by the iteration are copied, not the View.
+    //
+    // Outside replicas accesses go to the View directly. Capturing needs a
+    // host execution space, as replicas find their log through thread local
+    // storage.
+    template <typename ViewType>
+    class CapturedView
+    {
+    public:
+        using view_type = ViewType;
+        using value_type = typename ViewType::value_type;
+        using memory_space = typename ViewType::memory_space;
+
+        CapturedView() = default;
+
+        explicit CapturedView(ViewType const& view)
+          : view_(view)
+        {
+        }
+
+        template <typename... Index>
+        KOKKOS_FORCEINLINE_FUNCTION value_type& operator()(
+            Index... i) const
+        {
+            value_type& element = view_(i...);
+
+            KOKKOS_IF_ON_HOST((
+                if (WriteLog* log = current_write_log())
+                    return log->record(element);
+            ))
+
+            return element;
+        }
+
+        KOKKOS_FUNCTION std::size_t extent(unsigned r) const
+        {
+            return view_.extent(r);
+        }
+
+        ViewType const& view() const noexcept
+        {
+            return view_;
+        }
+
+    private:
+        ViewType view_;
+    };
+
+    template <typename ViewType>
+    CapturedView<ViewType> capture(ViewType const& view)
+    {
+        return CapturedView<ViewType>(view);
+    }
+
+}}}    // namespace Kokkos::resilience::util
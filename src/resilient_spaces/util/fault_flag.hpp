@@ -0,0 +1,135 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <Kokkos_Core.hpp>
+
+#include <resilient_spaces/util/scratch_arena.hpp>
+
+#include <type_traits>
+
+namespace Kokkos { namespace resilience { namespace util {
+
+    // Execution spaces running on the host can write host memory directly.
+    template <typename ExecutionSpace>
+    struct is_host_space
+      : std::integral_constant<bool,
+            Kokkos::SpaceAccessibility<ExecutionSpace,
+                Kokkos::HostSpace>::accessible>
+    {
+    };
+
+    template <typename ExecutionSpace>
+    struct is_serial_space : std::false_type
+    {
+    };
+
+#if defined(KOKKOS_ENABLE_SERIAL)
+    template <>
+    struct is_serial_space<Kokkos::Serial> : std::true_type
+    {
+    };
+#endif
+
+    // Set by the resilient functors once a result could not be corrected,
+    // read on the host after the kernel.
+    //
+    // Device spaces keep the flag in a scratch buffer of the memory space.
+    // Host spaces keep it in the flag object constructed on the host. In
+    // both cases copies made for the kernel refer to the flag of that
+    // object, which must outlive the kernel and its copies.
+    //
+    // The host flag object must also stay in place: its move operations are
+    // deleted, and objects holding one are copied instead of moved. Owners
+    // of a flag whose copies outlive a launch, e.g. the wrapping functors
+    // kept by the ParallelFor closures of a LaunchPlan, are never moved.
+    template <typename ExecutionSpace, typename = void>
+    class FaultFlag
+    {
+    public:
+        FaultFlag()
+          : flag_(1)
+        {
+            reset();
+        }
+
+        KOKKOS_FUNCTION void set() const
+        {
+            flag_(0) = true;
+        }
+
+        bool is_set() const
+        {
+            bool value = false;
+            Kokkos::deep_copy(
+                Kokkos::View<bool*, Kokkos::HostSpace,
+                    Kokkos::MemoryTraits<Kokkos::Unmanaged>>(&value, 1),
+                flag_.view());
+
+            return value;
+        }
+
+        void reset() const
+        {
+            Kokkos::deep_copy(flag_.view(), false);
+        }
+
+    private:
+        ScratchView<bool, typename ExecutionSpace::memory_space> flag_;
+    };
+
+    template <typename ExecutionSpace>
+    class FaultFlag<ExecutionSpace,
+        std::enable_if_t<is_host_space<ExecutionSpace>::value>>
+    {
+    public:
+        FaultFlag() noexcept
+          : flag_(&value_)
+        {
+        }
+
+        FaultFlag(FaultFlag const& other) noexcept
+          : flag_(other.flag_)
+        {
+        }
+
+        FaultFlag& operator=(FaultFlag const& other) noexcept
+        {
+            flag_ = other.flag_;
+            return *this;
+        }
+
+        // Copies refer to the flag of this object
+        FaultFlag(FaultFlag&&) = delete;
+        FaultFlag& operator=(FaultFlag&&) = delete;
+
+        // Concurrent writers all store 1
+        KOKKOS_FUNCTION void set() const
+        {
+            Kokkos::atomic_store(flag_, 1);
+        }
+
+        bool is_set() const
+        {
+            // Serial kernels complete before returning
+            if constexpr (!is_serial_space<ExecutionSpace>::value)
+                Kokkos::fence();
+
+            return Kokkos::atomic_load(flag_) != 0;
+        }
+
+        void reset() const
+        {
+            Kokkos::atomic_store(flag_, 0);
+        }
+
+    private:
+        int value_ = 0;
+        int* flag_;
+    };
+
+}}}    // namespace Kokkos::resilience::util
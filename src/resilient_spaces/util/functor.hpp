@@ -6,8 +6,18 @@
 
 #pragma once
 
+#include <resilient_spaces/util/captured_view.hpp>
+#include <resilient_spaces/util/fault_flag.hpp>
+#include <resilient_spaces/util/hash.hpp>
+#include <resilient_spaces/util/retry_queue.hpp>
+#include <resilient_spaces/util/traits.hpp>
+#include <resilient_spaces/util/vote.hpp>
+
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <type_traits>
+#include <utility>
 
 namespace Kokkos { namespace resilience { namespace util {
 
@@ -20,7 +30,6 @@ namespace Kokkos { namespace resilience { namespace util {
           : functor(f)
           , validator(v)
           , replays(n)
-          , incorrect_("result_correctness", 1)
         {
         }
 
@@ -30,31 +39,27 @@ namespace Kokkos { namespace resilience { namespace util {
             for (std::uint64_t n = 0u; n != replays; ++n)
             {
                 auto result = functor(i...);
-                bool is_correct = validator(i..., result);
+                bool is_correct =
+                    traits::invoke_validator(validator, i..., result);
 
                 if (is_correct)
                     break;
 
                 if (n == replays - 1)
-                    incorrect_[0] = true;
+                    incorrect_.set();
             }
         }
 
         bool is_incorrect() const
         {
-            Kokkos::View<bool*, Kokkos::DefaultHostExecutionSpace>
-                return_result("is_correct", 1);
-
-            Kokkos::deep_copy(return_result, incorrect_);
-
-            return return_result[0];
+            return incorrect_.is_set();
         }
 
     private:
         const Functor functor;
         const Validator validator;
         std::uint64_t replays;
-        Kokkos::View<bool*, ExecutionSpace> incorrect_;
+        FaultFlag<ExecutionSpace> incorrect_;
     };
 
     template <typename ExecutionSpace, typename Functor, typename Validator>
@@ -66,50 +71,35 @@ namespace Kokkos { namespace resilience { namespace util {
           : functor(f)
           , validator(v)
           , replicates(n)
-          , incorrect_("result_correctness", 1)
         {
         }
 
         template <typename... ValueType>
         KOKKOS_FUNCTION void operator()(ValueType&&... i) const
         {
-            using return_type =
-                typename std::invoke_result<Functor, ValueType...>::type;
-
             bool is_valid = false;
-            return_type final_result{};
 
             for (std::uint64_t n = 0u; n != replicates; ++n)
             {
                 auto result = functor(i...);
-                bool is_correct = validator(i..., result);
-
-                if (is_correct && !is_valid)
-                {
-                    final_result = result;
-                    is_valid = true;
-                }
+                is_valid = traits::invoke_validator(validator, i..., result) ||
+                    is_valid;
             }
 
             if (!is_valid)
-                incorrect_[0] = true;
+                incorrect_.set();
         }
 
         bool is_incorrect() const
         {
-            Kokkos::View<bool*, Kokkos::DefaultHostExecutionSpace>
-                return_result("is_correct", 1);
-
-            Kokkos::deep_copy(return_result, incorrect_);
-
-            return return_result[0];
+            return incorrect_.is_set();
         }
 
     private:
         const Functor functor;
         const Validator validator;
         std::uint64_t replicates;
-        Kokkos::View<bool*, ExecutionSpace> incorrect_;
+        FaultFlag<ExecutionSpace> incorrect_;
     };
 
     template <typename ExecutionSpace, typename Functor>
@@ -118,43 +108,550 @@ namespace Kokkos { namespace resilience { namespace util {
     public:
         KOKKOS_FUNCTION ResilientReplicateFunctor(Functor const& f)
           : functor(f)
-          , incorrect_("result_correctness", 1)
         {
         }
 
         template <typename... ValueType>
         KOKKOS_FUNCTION void operator()(ValueType&&... i) const
         {
-            auto result_1 = functor(std::forward<ValueType>(i)...);
-            auto result_2 = functor(std::forward<ValueType>(i)...);
+            using return_type =
+                typename std::invoke_result<Functor, ValueType...>::type;
 
-            if (result_1 == result_2)
-                return;
+            if constexpr (std::is_void<return_type>::value)
+            {
+                replicate_writes(i...);
+            }
+            else
+            {
+                auto result_1 = functor(std::forward<ValueType>(i)...);
+                auto result_2 = functor(std::forward<ValueType>(i)...);
+
+                if (equal(result_1, result_2))
+                    return;
+
+                // The writes of the third replica are kept, every lane of
+                // its result must agree with one of the others
+                auto result_3 = functor(std::forward<ValueType>(i)...);
+
+                if (agrees(result_3, result_1, result_2))
+                    return;
+
+                incorrect_.set();
+            }
+        }
+
+        bool is_incorrect() const
+        {
+            return incorrect_.is_set();
+        }
+
+        bool is_overflowed() const
+        {
+            return overflow_.is_set();
+        }
+
+    private:
+        // Void functors write through CapturedViews, the replicas compare
+        // their write logs instead of results.
+        template <typename... ValueType>
+        KOKKOS_FUNCTION void replicate_writes(ValueType const&... i) const
+        {
+            static_assert(is_host_space<ExecutionSpace>::value,
+                "Replicating void functors requires a host execution "
+                "space.");
+
+            KOKKOS_IF_ON_HOST((
+                WriteLog logs[3];
+
+                auto const run = [&](WriteLog& log) {
+                    current_write_log() = &log;
+                    functor(i...);
+                    current_write_log() = nullptr;
+                    return log.overflow();
+                };
+
+                if (run(logs[0]) || run(logs[1]))
+                {
+                    overflow_.set();
+                    return;
+                }
+
+                if (logs[0] == logs[1])
+                {
+                    logs[0].commit();
+                    return;
+                }
+
+                if (run(logs[2]))
+                {
+                    overflow_.set();
+                    return;
+                }
+
+                if (logs[2] == logs[0] || logs[2] == logs[1])
+                {
+                    logs[2].commit();
+                    return;
+                }
+
+                incorrect_.set();
+            ))
+        }
+
+        const Functor functor;
+        FaultFlag<ExecutionSpace> incorrect_;
+        FaultFlag<ExecutionSpace> overflow_;
+    };
+
+    // Row-major offsets of the points of a RangePolicy (rank 1) or an
+    // MDRangePolicy, so that points can be queued in a RetryQueue.
+    template <typename IndexType, int Rank>
+    struct PolicyPoints
+    {
+        using point_type = Kokkos::Array<IndexType, Rank>;
+
+        point_type lower;
+        point_type extent;
+
+        std::size_t size() const
+        {
+            std::size_t points = 1;
+            for (int d = 0; d != Rank; ++d)
+                points *= std::size_t(extent[d]);
+            return points;
+        }
+
+        // Offset of the point of a call, after the work tag of tagged
+        // policies
+        template <typename WorkTag, typename... Args>
+        KOKKOS_FORCEINLINE_FUNCTION std::size_t offset(
+            Args const&... args) const
+        {
+            if constexpr (std::is_void<WorkTag>::value)
+                return linear(args...);
+            else
+                return untagged(args...);
+        }
+
+        // Calls the functor at the point of offset k
+        template <typename WorkTag, typename Functor>
+        KOKKOS_FORCEINLINE_FUNCTION auto invoke(
+            Functor const& functor, std::size_t k) const
+        {
+            point_type point;
+            for (int d = Rank - 1; d >= 0; --d)
+            {
+                point[d] = lower[d] + IndexType(k % std::size_t(extent[d]));
+                k /= std::size_t(extent[d]);
+            }
+            return call<WorkTag>(
+                functor, point, std::make_index_sequence<Rank>{});
+        }
+
+    private:
+        template <typename Tag, typename... IndexTypes>
+        KOKKOS_FORCEINLINE_FUNCTION std::size_t untagged(
+            Tag const&, IndexTypes const&... i) const
+        {
+            return linear(i...);
+        }
+
+        template <typename... IndexTypes>
+        KOKKOS_FORCEINLINE_FUNCTION std::size_t linear(
+            IndexTypes const&... i) const
+        {
+            IndexType const point[] = {IndexType(i)...};
+
+            std::size_t k = 0;
+            for (int d = 0; d != Rank; ++d)
+                k = k * std::size_t(extent[d]) +
+                    std::size_t(point[d] - lower[d]);
+            return k;
+        }
+
+        template <typename WorkTag, typename Functor, std::size_t... D>
+        static KOKKOS_FORCEINLINE_FUNCTION auto call(Functor const& functor,
+            point_type const& point, std::index_sequence<D...>)
+        {
+            return traits::invoke_tagged<WorkTag>(functor, point[D]...);
+        }
+    };
+
+    // First pass of ResilientShadowReplicate: the functor and its shadow run
+    // on every point, points where they disagree are queued for the second
+    // pass. The shadow runs first, its writes are overwritten by the
+    // functor. The only branch is the rarely taken push, so that both
+    // evaluations vectorize together.
+    template <typename ExecutionSpace, typename Functor, typename Shadow,
+        typename WorkTag, typename Points>
+    class ResilientShadowCheckFunctor
+    {
+    public:
+        using shadow_functor = typename Functor::template rebind<Shadow>;
+        using queue_type = RetryQueue<ExecutionSpace, std::size_t>;
+
+        ResilientShadowCheckFunctor(Functor const& f, double relative,
+            double absolute, Points const& points, queue_type const& queue)
+          : functor(f)
+          , shadow(f)
+          , relative_(relative)
+          , absolute_(absolute)
+          , points_(points)
+          , queue_(queue)
+        {
+        }
+
+        template <typename... Args>
+        KOKKOS_FUNCTION void operator()(Args const&... args) const
+        {
+            auto const expected = shadow(args...);
+            auto const result = functor(args...);
+
+            // Queues covering the points never reject a push
+            if (!within(result, expected, relative_, absolute_))
+                queue_.push(points_.template offset<WorkTag>(args...));
+        }
+
+    private:
+        const Functor functor;
+        const shadow_functor shadow;
+        double relative_;
+        double absolute_;
+        Points points_;
+        queue_type queue_;
+    };
+
+    // Second pass of ResilientShadowReplicate over the points queued by the
+    // first, its queued slots and then its overflow words. Either replica
+    // may have been faulty, the functor is evaluated again to decide.
+    template <typename ExecutionSpace, typename Functor, typename Shadow,
+        typename WorkTag, typename Points>
+    class ResilientShadowReplicateFunctor
+    {
+    public:
+        using shadow_functor = typename Functor::template rebind<Shadow>;
+        using queue_type = RetryQueue<ExecutionSpace, std::size_t>;
+
+        ResilientShadowReplicateFunctor(Functor const& f, double relative,
+            double absolute, Points const& points, queue_type const& queue,
+            std::size_t queued)
+          : functor(f)
+          , shadow(f)
+          , relative_(relative)
+          , absolute_(absolute)
+          , points_(points)
+          , queue_(queue)
+          , queued_(queued)
+        {
+        }
+
+        KOKKOS_FUNCTION void operator()(std::size_t slot) const
+        {
+            if (slot < queued_)
+                return replicate(queue_[slot]);
+
+            std::size_t const word = slot - queued_;
+            std::uint64_t const bits = queue_.take_overflow(word);
+            for (std::size_t b = 0; b != queue_type::word_bits; ++b)
+            {
+                if ((bits >> b) & 1)
+                    replicate(queue_.overflow_index(word, b));
+            }
+        }
 
-            auto result_3 = functor(std::forward<ValueType>(i)...);
+        bool is_incorrect() const
+        {
+            return incorrect_.is_set();
+        }
 
-            if (result_1 == result_3)
+    private:
+        KOKKOS_FUNCTION void replicate(std::size_t k) const
+        {
+            auto const expected = points_.template invoke<WorkTag>(shadow, k);
+            auto const result_1 = points_.template invoke<WorkTag>(functor, k);
+
+            if (within(result_1, expected, relative_, absolute_))
                 return;
 
-            if (result_2 == result_3)
+            auto const result_2 = points_.template invoke<WorkTag>(functor, k);
+
+            if (equal(result_1, result_2) ||
+                within(result_2, expected, relative_, absolute_))
                 return;
 
-            incorrect_[0] = true;
+            incorrect_.set();
+        }
+
+        const Functor functor;
+        const shadow_functor shadow;
+        double relative_;
+        double absolute_;
+        Points points_;
+        queue_type queue_;
+        std::size_t queued_;
+        FaultFlag<ExecutionSpace> incorrect_;
+    };
+
+    // Runs a tile until two passes agree, at most three times. A pass
+    // returns the hash of the results of the tile.
+    template <typename Pass>
+    KOKKOS_INLINE_FUNCTION bool replicate_tile(Pass const& pass)
+    {
+        std::uint64_t const hash_1 = pass();
+        std::uint64_t const hash_2 = pass();
+
+        if (hash_1 == hash_2)
+            return true;
+
+        // The writes of the third pass are kept, it must agree with one
+        std::uint64_t const hash_3 = pass();
+
+        return hash_3 == hash_1 || hash_3 == hash_2;
+    }
+
+    // Tile t of ResilientReplicateTiled on a RangePolicy covers the indices
+    // [begin + t * tile, begin + (t + 1) * tile) clamped to end.
+    template <typename ExecutionSpace, typename Functor, typename WorkTag,
+        typename IndexType>
+    class ResilientReplicateTileFunctor
+    {
+    public:
+        ResilientReplicateTileFunctor(
+            Functor const& f, IndexType begin, IndexType end, IndexType tile)
+          : functor(f)
+          , begin_(begin)
+          , end_(end)
+          , tile_(tile)
+        {
+        }
+
+        KOKKOS_FUNCTION void operator()(IndexType t) const
+        {
+            IndexType const first = begin_ + t * tile_;
+            IndexType const last =
+                end_ - first < tile_ ? end_ : first + tile_;
+
+            auto const pass = [&]() {
+                std::uint64_t hash = 0;
+                for (IndexType i = first; i != last; ++i)
+                {
+                    auto const result =
+                        traits::invoke_tagged<WorkTag>(functor, i);
+                    hash = mix(hash ^ fingerprint(result));
+                }
+                return hash;
+            };
+
+            if (!replicate_tile(pass))
+                incorrect_.set();
         }
 
         bool is_incorrect() const
         {
-            Kokkos::View<bool*, Kokkos::DefaultHostExecutionSpace>
-                return_result("is_correct", 1);
+            return incorrect_.is_set();
+        }
+
+    private:
+        const Functor functor;
+        IndexType begin_;
+        IndexType end_;
+        IndexType tile_;
+        FaultFlag<ExecutionSpace> incorrect_;
+    };
+
+    // Tile t of ResilientReplicateTiled on an MDRangePolicy, tiles are
+    // numbered and their points visited with the last index fastest.
+    template <typename ExecutionSpace, typename Functor, typename WorkTag,
+        typename PointType, int Rank>
+    class ResilientReplicateMDTileFunctor
+    {
+    public:
+        ResilientReplicateMDTileFunctor(Functor const& f,
+            PointType const& lower, PointType const& upper,
+            PointType const& tile)
+          : functor(f)
+          , lower_(lower)
+          , upper_(upper)
+          , tile_(tile)
+        {
+        }
 
-            Kokkos::deep_copy(return_result, incorrect_);
+        // Number of tiles
+        std::size_t size() const
+        {
+            std::size_t tiles = 1;
+            for (int d = 0; d != Rank; ++d)
+                tiles *= (upper_[d] - lower_[d] + tile_[d] - 1) / tile_[d];
+            return tiles;
+        }
 
-            return return_result[0];
+        KOKKOS_FUNCTION void operator()(std::size_t t) const
+        {
+            PointType first;
+            PointType last;
+            for (int d = Rank - 1; d >= 0; --d)
+            {
+                std::size_t const tiles =
+                    (upper_[d] - lower_[d] + tile_[d] - 1) / tile_[d];
+
+                first[d] = lower_[d] + (t % tiles) * tile_[d];
+                last[d] = upper_[d] - first[d] < tile_[d] ?
+                    upper_[d] :
+                    first[d] + tile_[d];
+                t /= tiles;
+            }
+
+            auto const pass = [&]() {
+                std::uint64_t hash = 0;
+                PointType point = first;
+                for (;;)
+                {
+                    auto const result =
+                        call(point, std::make_index_sequence<Rank>{});
+                    hash = mix(hash ^ fingerprint(result));
+
+                    int d = Rank - 1;
+                    for (; d >= 0; --d)
+                    {
+                        if (++point[d] != last[d])
+                            break;
+                        point[d] = first[d];
+                    }
+                    if (d < 0)
+                        return hash;
+                }
+            };
+
+            if (!replicate_tile(pass))
+                incorrect_.set();
+        }
+
+        bool is_incorrect() const
+        {
+            return incorrect_.is_set();
+        }
+
+    private:
+        template <std::size_t... D>
+        KOKKOS_FORCEINLINE_FUNCTION auto call(
+            PointType const& point, std::index_sequence<D...>) const
+        {
+            return traits::invoke_tagged<WorkTag>(functor, point[D]...);
+        }
+
+        const Functor functor;
+        PointType lower_;
+        PointType upper_;
+        PointType tile_;
+        FaultFlag<ExecutionSpace> incorrect_;
+    };
+
+    // One replica of ResilientReplicateDiverse: iteration k evaluates index
+    // (k + offset) mod n and stores its result at k, so each thread writes
+    // a contiguous part of the shadow buffer.
+    template <typename Functor, typename WorkTag, typename IndexType,
+        typename ShadowView>
+    class ResilientReplicateDiverseFunctor
+    {
+    public:
+        ResilientReplicateDiverseFunctor(Functor const& f,
+            ShadowView const& shadow, IndexType begin, std::size_t offset)
+          : functor(f)
+          , shadow_(shadow)
+          , begin_(begin)
+          , offset_(offset)
+        {
+        }
+
+        KOKKOS_FUNCTION void operator()(IndexType k) const
+        {
+            run(k);
+        }
+
+        template <typename Tag>
+        KOKKOS_FUNCTION void operator()(Tag const&, IndexType k) const
+        {
+            run(k);
+        }
+
+    private:
+        KOKKOS_FUNCTION void run(IndexType k) const
+        {
+            std::size_t const n = shadow_.extent(0);
+            std::size_t const slot = std::size_t(k - begin_);
+            IndexType const i = begin_ + IndexType((slot + offset_) % n);
+
+            shadow_(slot) = traits::invoke_tagged<WorkTag>(functor, i);
+        }
+
+        const Functor functor;
+        ShadowView shadow_;
+        IndexType begin_;
+        std::size_t offset_;
+    };
+
+    // Majority vote over the shadow buffers of the three diverse replicas.
+    // The vote is built lane by lane (see majority), so array results have
+    // one even if every replica is wrong in a different lane. The writes of
+    // the functor are those of the last replica, an index where it differs
+    // from the vote is evaluated again to replace them, and the result must
+    // match the vote in every lane.
+    template <typename ExecutionSpace, typename Functor, typename WorkTag,
+        typename IndexType, typename ShadowView>
+    class ResilientReplicateVoteFunctor
+    {
+    public:
+        ResilientReplicateVoteFunctor(Functor const& f, IndexType begin,
+            ShadowView const& s0, ShadowView const& s1, ShadowView const& s2,
+            std::size_t offset1, std::size_t offset2)
+          : functor(f)
+          , begin_(begin)
+          , s0_(s0)
+          , s1_(s1)
+          , s2_(s2)
+          , offset1_(offset1)
+          , offset2_(offset2)
+        {
+        }
+
+        KOKKOS_FUNCTION void operator()(std::size_t j) const
+        {
+            std::size_t const n = s0_.extent(0);
+
+            auto const& result_1 = s0_(j);
+            auto const& result_2 = s1_((j + n - offset1_) % n);
+            auto const& result_3 = s2_((j + n - offset2_) % n);
+
+            auto vote = result_1;
+            if (!equal(result_1, result_2) &&
+                !majority(result_1, result_2, result_3, vote))
+            {
+                incorrect_.set();
+                return;
+            }
+
+            if (equal(result_3, vote))
+                return;
+
+            IndexType const i = begin_ + IndexType(j);
+            if (!equal(traits::invoke_tagged<WorkTag>(functor, i), vote))
+                incorrect_.set();
+        }
+
+        bool is_incorrect() const
+        {
+            return incorrect_.is_set();
         }
 
     private:
         const Functor functor;
-        Kokkos::View<bool*, ExecutionSpace> incorrect_;
+        IndexType begin_;
+        ShadowView s0_;
+        ShadowView s1_;
+        ShadowView s2_;
+        std::size_t offset1_;
+        std::size_t offset2_;
+        FaultFlag<ExecutionSpace> incorrect_;
     };
 
 }}}    // namespace Kokkos::resilience::util
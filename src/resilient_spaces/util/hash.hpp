@@ -0,0 +1,49 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <Kokkos_Core.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace Kokkos { namespace resilience { namespace util {
+
+    // splitmix64 finalizer
+    KOKKOS_INLINE_FUNCTION std::uint64_t mix(std::uint64_t x)
+    {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ull;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebull;
+        x ^= x >> 31;
+        return x;
+    }
+
+    // Hash of the object representation, so that NaNs and signed zeros
+    // are told apart.
+    template <typename T>
+    KOKKOS_INLINE_FUNCTION std::uint64_t fingerprint(T const& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value,
+            "Fingerprinted values must be trivially copyable.");
+
+        auto const bytes = reinterpret_cast<unsigned char const*>(&value);
+
+        std::uint64_t hash = sizeof(T);
+        for (std::size_t b = 0; b < sizeof(T); b += 8)
+        {
+            std::uint64_t word = 0;
+            for (std::size_t k = 0; k != 8 && b + k != sizeof(T); ++k)
+                word |= std::uint64_t(bytes[b + k]) << (8 * k);
+            hash = mix(hash ^ word);
+        }
+        return hash;
+    }
+
+}}}    // namespace Kokkos::resilience::util
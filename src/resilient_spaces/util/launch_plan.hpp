@@ -0,0 +1,97 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <Kokkos_Core.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Kokkos { namespace resilience {
+
+    // Kernels launched with the same policy and functor over and over, e.g.
+    // the kernels of a timestep. The closure of each kernel (for resilient
+    // policies the wrapping functor, fault flag, retry queues and validator)
+    // is built once when the kernel is added, submit() only relaunches it.
+    //
+    // Functors are captured by value: Views they hold are shared, so new
+    // data in the same Views is picked up, but kernels swapping Views
+    // between timesteps need one plan per arrangement.
+    class LaunchPlan
+    {
+    public:
+        LaunchPlan() = default;
+
+        LaunchPlan(LaunchPlan const&) = delete;
+        LaunchPlan& operator=(LaunchPlan const&) = delete;
+
+        LaunchPlan(LaunchPlan&&) = default;
+        LaunchPlan& operator=(LaunchPlan&&) = default;
+
+        template <typename Policy, typename Functor>
+        void parallel_for(
+            std::string label, Policy const& policy, Functor const& functor)
+        {
+            using closure_type = Kokkos::Impl::ParallelFor<Functor, Policy,
+                typename Policy::execution_space>;
+
+            // Closures reference their own members and are never moved
+            auto closure =
+                std::make_shared<closure_type const>(functor, policy);
+
+            kernels_.emplace_back([label = std::move(label), closure] {
+                if (label.empty())
+                    return closure->execute();
+
+                Kokkos::Tools::pushRegion(label);
+                try
+                {
+                    closure->execute();
+                }
+                catch (...)
+                {
+                    Kokkos::Tools::popRegion();
+                    throw;
+                }
+                Kokkos::Tools::popRegion();
+            });
+        }
+
+        template <typename Policy, typename Functor>
+        void parallel_for(Policy const& policy, Functor const& functor)
+        {
+            parallel_for(std::string(), policy, functor);
+        }
+
+        // Launches all kernels in the order they were added. Like
+        // Kokkos::parallel_for, kernels may still run when it returns,
+        // failures of resilient kernels are thrown.
+        void submit() const
+        {
+            for (auto const& kernel : kernels_)
+                kernel();
+        }
+
+        std::size_t size() const noexcept
+        {
+            return kernels_.size();
+        }
+
+        void clear()
+        {
+            kernels_.clear();
+        }
+
+    private:
+        std::vector<std::function<void()>> kernels_;
+    };
+
+}}    // namespace Kokkos::resilience
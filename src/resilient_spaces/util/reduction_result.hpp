@@ -0,0 +1,107 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <Kokkos_Core.hpp>
+
+#include <resilient_spaces/util/scratch_arena.hpp>
+
+#include <algorithm>
+#include <cstddef>
+
+namespace Kokkos { namespace resilience { namespace util {
+
+    // Destination of a replayed reduction: all value_count elements of the
+    // result, in any memory space accessible from the execution space, are
+    // saved before the first attempt and restored after a rejected one.
+    //
+    // Results in host accessible memory are saved on the host and handed
+    // to the validator in place. Device results are saved and restored
+    // asynchronously on the execution space, only the copy to the host for
+    // validation synchronizes. The buffers are drawn from the scratch arena
+    // when the result is constructed and kept by it, so that the attempts
+    // allocate nothing. Copies are views of the buffers and must not
+    // outlive the original.
+    template <typename ValueType, typename ExecutionSpace>
+    class ReductionResult
+    {
+    public:
+        using device_space = typename ExecutionSpace::memory_space;
+        using device_view = Kokkos::View<ValueType*, device_space,
+            Kokkos::MemoryTraits<Kokkos::Unmanaged>>;
+
+        template <typename ViewType>
+        ReductionResult(ExecutionSpace const& space, ViewType const& view,
+            std::size_t count)
+          : space_(space)
+          , result_(view.data())
+          , count_(count)
+          , on_host_(Kokkos::SpaceAccessibility<Kokkos::HostSpace,
+                typename ViewType::memory_space>::accessible)
+          , host_(count)
+          , backup_(on_host_ ? 0 : count)
+        {
+            static_assert(Kokkos::SpaceAccessibility<ExecutionSpace,
+                              typename ViewType::memory_space>::accessible,
+                "Replayed reductions require a result accessible from the "
+                "execution space.");
+        }
+
+        std::size_t count() const noexcept
+        {
+            return count_;
+        }
+
+        void save() const
+        {
+            if (on_host_)
+                std::copy(result_, result_ + count_, host_.view().data());
+            else
+                Kokkos::deep_copy(space_, backup_.view(), result());
+        }
+
+        void restore() const
+        {
+            if (on_host_)
+                std::copy(host_.view().data(), host_.view().data() + count_,
+                    result_);
+            else
+                Kokkos::deep_copy(space_, result(), backup_.view());
+        }
+
+        // Waits for the reduction, the values stay valid until the next
+        // call.
+        ValueType* read() const
+        {
+            if (on_host_)
+            {
+                space_.fence();
+                return result_;
+            }
+
+            Kokkos::deep_copy(space_, host_.view(), result());
+            space_.fence();
+            return host_.view().data();
+        }
+
+    private:
+        device_view result() const
+        {
+            return device_view(result_, count_);
+        }
+
+        ExecutionSpace space_;
+        ValueType* result_;
+        std::size_t count_;
+        bool on_host_;
+
+        // Backup of host results, copy of device results for validation
+        ScratchView<ValueType, Kokkos::HostSpace> host_;
+        ScratchView<ValueType, device_space> backup_;
+    };
+
+}}}    // namespace Kokkos::resilience::util
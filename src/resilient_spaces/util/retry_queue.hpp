@@ -0,0 +1,343 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <Kokkos_Core.hpp>
+
+#include <resilient_spaces/util/fault_flag.hpp>
+#include <resilient_spaces/util/scratch_arena.hpp>
+#include <resilient_spaces/util/traits.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace Kokkos { namespace resilience { namespace util {
+
+    // Lock-free queue of failed indices. A push reserves a slot with a
+    // single atomic increment. Queues covering an index range keep the
+    // indices pushed once the slots are used up in an overflow bitmap of
+    // the range, so a burst of any size is retried in rounds. Queues
+    // without a range reject pushes beyond their capacity, callers then
+    // retry the index inline. The storage is drawn from the scratch arena
+    // and owned by the queue constructed with a capacity, copies refer to
+    // it.
+    template <typename ExecutionSpace, typename IndexType>
+    class RetryQueue
+    {
+    public:
+        using index_type = IndexType;
+
+        static constexpr std::size_t word_bits = 64;
+
+        RetryQueue() = default;
+
+        // Queues without capacity allocate nothing and reject every push
+        explicit RetryQueue(std::size_t capacity)
+          : capacity_(capacity)
+        {
+            if (capacity_ == 0)
+                return;
+
+            indices_ = storage<IndexType>(capacity_);
+            count_ = storage<std::size_t>(1);
+            clear();
+        }
+
+        // Queue of indices in [begin, end), the bitmap takes one bit per
+        // index of the range beyond the capacity
+        RetryQueue(std::size_t capacity, IndexType begin, IndexType end)
+          : RetryQueue(capacity)
+        {
+            std::size_t const range = std::size_t(end - begin);
+            if (capacity_ == 0 || capacity_ >= range)
+                return;
+
+            begin_ = begin;
+            words_ = (range + word_bits - 1) / word_bits;
+            overflow_ = storage<std::uint64_t>(words_);
+            Kokkos::deep_copy(overflow_.view(), std::uint64_t(0));
+        }
+
+        KOKKOS_FUNCTION bool push(IndexType i) const
+        {
+            if (capacity_ == 0)
+                return false;
+
+            std::size_t const slot =
+                Kokkos::atomic_fetch_add(&count_(0), std::size_t(1));
+            if (slot < capacity_)
+            {
+                indices_(slot) = i;
+                return true;
+            }
+
+            if (words_ == 0)
+                return false;
+
+            std::size_t const bit = std::size_t(i - begin_);
+            Kokkos::atomic_fetch_or(&overflow_(bit / word_bits),
+                std::uint64_t(1) << (bit % word_bits));
+            return true;
+        }
+
+        KOKKOS_FUNCTION IndexType operator[](std::size_t slot) const
+        {
+            return indices_(slot);
+        }
+
+        // Takes the indices of an overflow word, clearing it. Bit b of the
+        // result stands for index overflow_index(word, b).
+        KOKKOS_FUNCTION std::uint64_t take_overflow(std::size_t word) const
+        {
+            std::uint64_t const bits = overflow_(word);
+            overflow_(word) = 0;
+            return bits;
+        }
+
+        KOKKOS_FUNCTION IndexType overflow_index(
+            std::size_t word, std::size_t bit) const
+        {
+            return begin_ + IndexType(word * word_bits + bit);
+        }
+
+        // Number of pushes since the last clear, including those kept in
+        // the overflow bitmap, synchronizes with the host
+        std::size_t count() const
+        {
+            if (capacity_ == 0)
+                return 0;
+
+            std::size_t count = 0;
+            Kokkos::deep_copy(
+                Kokkos::View<std::size_t*, Kokkos::HostSpace,
+                    Kokkos::MemoryTraits<Kokkos::Unmanaged>>(&count, 1),
+                count_.view());
+            return count;
+        }
+
+        // Number of queued indices, synchronizes with the host
+        std::size_t size() const
+        {
+            return queued(count());
+        }
+
+        std::size_t queued(std::size_t count) const noexcept
+        {
+            return (std::min)(count, capacity_);
+        }
+
+        // Work items of a round draining count pushes: one per queued
+        // index, and one per overflow word if the queue overflowed.
+        std::size_t slots(std::size_t count) const noexcept
+        {
+            return queued(count) + (count > capacity_ ? words_ : 0);
+        }
+
+        // Overflow words are cleared by the round draining them
+        void clear() const
+        {
+            if (capacity_ != 0)
+                Kokkos::deep_copy(count_.view(), std::size_t(0));
+        }
+
+        std::size_t capacity() const noexcept
+        {
+            return capacity_;
+        }
+
+        // The slots hold a fraction of the range, larger bursts go to the
+        // overflow bitmap.
+        static std::size_t default_capacity(std::size_t range)
+        {
+            return (std::min)(range, (std::max)(std::size_t(1024), range / 64));
+        }
+
+        // Capacity of the queues of a replayed kernel. Serial spaces and
+        // ranges below inline_range retry failed indices inline instead,
+        // sparing the small launches the queue storage and its host
+        // synchronization.
+        static std::size_t replay_capacity(std::size_t range)
+        {
+            if (is_serial_space<ExecutionSpace>::value || range < inline_range)
+                return 0;
+
+            return default_capacity(range);
+        }
+
+        static constexpr std::size_t inline_range = 4096;
+
+    private:
+        template <typename T>
+        using storage =
+            ScratchView<T, typename ExecutionSpace::memory_space>;
+
+        storage<IndexType> indices_;
+        storage<std::size_t> count_;
+        storage<std::uint64_t> overflow_;
+        std::size_t capacity_ = 0;
+        std::size_t words_ = 0;
+        IndexType begin_ = 0;
+    };
+
+    namespace detail {
+
+        // Runs one attempt of index i, returns whether it validated.
+        template <typename WorkTag, typename Functor, typename Validator,
+            typename IndexType>
+        KOKKOS_FORCEINLINE_FUNCTION bool attempt(
+            Functor const& functor, Validator const& validator, IndexType i)
+        {
+            auto result = traits::invoke_tagged<WorkTag>(functor, i);
+
+            if constexpr (std::is_void<WorkTag>::value)
+                return traits::invoke_validator(validator, i, result);
+            else
+                return traits::invoke_validator(
+                    validator, WorkTag{}, i, result);
+        }
+
+    }    // namespace detail
+
+    // Primary pass of a replayed kernel: every index is run once and failed
+    // indices are queued for the retry rounds instead of stalling the
+    // thread that owns them.
+    template <typename ExecutionSpace, typename Functor, typename Validator,
+        typename WorkTag, typename IndexType>
+    class ResilientReplayQueueFunctor
+    {
+    public:
+        using queue_type = RetryQueue<ExecutionSpace, IndexType>;
+
+        ResilientReplayQueueFunctor(Functor const& f, Validator const& v,
+            std::uint64_t n, queue_type const& queue)
+          : functor(f)
+          , validator(v)
+          , replays(n)
+          , queue_(queue)
+        {
+        }
+
+        KOKKOS_FUNCTION void operator()(IndexType i) const
+        {
+            run(i);
+        }
+
+        template <typename Tag>
+        KOKKOS_FUNCTION void operator()(Tag const&, IndexType i) const
+        {
+            run(i);
+        }
+
+        bool is_incorrect() const
+        {
+            return incorrect_.is_set();
+        }
+
+        // Allows relaunching the functor
+        void reset() const
+        {
+            incorrect_.reset();
+        }
+
+    private:
+        KOKKOS_FUNCTION void run(IndexType i) const
+        {
+            if (detail::attempt<WorkTag>(functor, validator, i))
+                return;
+
+            if (replays > 1 && queue_.push(i))
+                return;
+
+            // The queue is full, retry inline
+            for (std::uint64_t n = 1; n < replays; ++n)
+            {
+                if (detail::attempt<WorkTag>(functor, validator, i))
+                    return;
+            }
+
+            incorrect_.set();
+        }
+
+        const Functor functor;
+        const Validator validator;
+        std::uint64_t replays;
+        queue_type queue_;
+        FaultFlag<ExecutionSpace> incorrect_;
+    };
+
+    // Retry round: drains the indices failed in the previous round, indices
+    // failing again are queued for the next one while attempts remain.
+    template <typename ExecutionSpace, typename Functor, typename Validator,
+        typename WorkTag, typename IndexType>
+    class ResilientReplayDrainFunctor
+    {
+    public:
+        using queue_type = RetryQueue<ExecutionSpace, IndexType>;
+
+        // Drains the queued indices of in and, past them, its overflow words
+        ResilientReplayDrainFunctor(Functor const& f, Validator const& v,
+            queue_type const& in, std::size_t queued, queue_type const& out,
+            std::uint64_t remaining)
+          : functor(f)
+          , validator(v)
+          , in_(in)
+          , queued_(queued)
+          , out_(out)
+          , remaining_(remaining)
+        {
+        }
+
+        KOKKOS_FUNCTION void operator()(std::size_t slot) const
+        {
+            if (slot < queued_)
+                return retry(in_[slot]);
+
+            std::size_t const word = slot - queued_;
+            std::uint64_t const bits = in_.take_overflow(word);
+            for (std::size_t b = 0; b != queue_type::word_bits; ++b)
+            {
+                if ((bits >> b) & 1)
+                    retry(in_.overflow_index(word, b));
+            }
+        }
+
+        bool is_incorrect() const
+        {
+            return incorrect_.is_set();
+        }
+
+    private:
+        KOKKOS_FUNCTION void retry(IndexType i) const
+        {
+            if (detail::attempt<WorkTag>(functor, validator, i))
+                return;
+
+            if (remaining_ != 0 && out_.push(i))
+                return;
+
+            // The queue is full, retry inline
+            for (std::uint64_t n = 0; n < remaining_; ++n)
+            {
+                if (detail::attempt<WorkTag>(functor, validator, i))
+                    return;
+            }
+
+            incorrect_.set();
+        }
+
+        const Functor functor;
+        const Validator validator;
+        queue_type in_;
+        std::size_t queued_;
+        queue_type out_;
+        std::uint64_t remaining_;
+        FaultFlag<ExecutionSpace> incorrect_;
+    };
+
+}}}    // namespace Kokkos::resilience::util
@@ -0,0 +1,225 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <Kokkos_Core.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace Kokkos { namespace resilience { namespace util {
+
+    struct ArenaStatistics
+    {
+        // Bytes allocated from the memory space
+        std::size_t reserved = 0;
+        // Bytes handed out and not yet returned
+        std::size_t in_use = 0;
+        std::size_t high_water_mark = 0;
+        // Blocks allocated from the memory space and blocks reused
+        std::size_t allocations = 0;
+        std::size_t reuses = 0;
+    };
+
+    // Grow-only pool for the scratch storage of the resilient kernels (fault
+    // flags, retry queues, replica shadows, reduction backups), one per
+    // memory space. Blocks are bucketed in power of two size classes and
+    // kept for reuse when returned, so steady-state launches allocate
+    // nothing. The cached blocks are freed by Kokkos::finalize.
+    //
+    // Blocks are exclusive to their holder, so the execution space
+    // instances sharing a memory space share its arena.
+    template <typename MemorySpace>
+    class ScratchArena
+    {
+    public:
+        static constexpr std::size_t min_block = 64;
+
+        static ScratchArena& instance()
+        {
+            // Never destroyed, blocks must be freed before finalize
+            static ScratchArena* const arena = new ScratchArena();
+            return *arena;
+        }
+
+        ScratchArena(ScratchArena const&) = delete;
+        ScratchArena& operator=(ScratchArena const&) = delete;
+
+        // Uninitialized block of at least the given size
+        void* acquire(std::size_t bytes)
+        {
+            std::size_t const cls = size_class(bytes);
+            std::size_t const size = min_block << cls;
+
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            void* block = nullptr;
+            if (!free_[cls].empty())
+            {
+                block = free_[cls].back();
+                free_[cls].pop_back();
+                ++statistics_.reuses;
+            }
+            else
+            {
+                if (statistics_.reserved == 0)
+                    Kokkos::push_finalize_hook([this] { release_cached(); });
+
+                block = Kokkos::kokkos_malloc<MemorySpace>(
+                    "krs_scratch_arena", size);
+                statistics_.reserved += size;
+                ++statistics_.allocations;
+            }
+
+            statistics_.in_use += size;
+            statistics_.high_water_mark = (std::max)(
+                statistics_.high_water_mark, statistics_.in_use);
+
+            return block;
+        }
+
+        // The size must be the one the block was acquired with
+        void release(void* block, std::size_t bytes)
+        {
+            std::size_t const cls = size_class(bytes);
+
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            free_[cls].push_back(block);
+            statistics_.in_use -= min_block << cls;
+        }
+
+        ArenaStatistics statistics() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return statistics_;
+        }
+
+    private:
+        ScratchArena() = default;
+
+        static std::size_t size_class(std::size_t bytes)
+        {
+            std::size_t cls = 0;
+            while ((min_block << cls) < bytes)
+                ++cls;
+            return cls;
+        }
+
+        // Blocks still in use at finalize stay reserved
+        void release_cached()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            for (std::size_t cls = 0; cls != free_.size(); ++cls)
+            {
+                for (void* block : free_[cls])
+                {
+                    Kokkos::kokkos_free<MemorySpace>(block);
+                    statistics_.reserved -= min_block << cls;
+                }
+                free_[cls].clear();
+            }
+        }
+
+        mutable std::mutex mutex_;
+        std::vector<std::vector<void*>> free_ =
+            std::vector<std::vector<void*>>(64);
+        ArenaStatistics statistics_;
+    };
+
+    // Rank-1 buffer drawn from the arena of its memory space. The object
+    // constructed with a size owns the block and returns it when
+    // destroyed; copies, like the ones captured by kernels, are unmanaged
+    // views of it and must not outlive the owner.
+    template <typename T, typename MemorySpace>
+    class ScratchView
+    {
+        static_assert(std::is_trivially_copyable<T>::value,
+            "Scratch buffers hold trivially copyable values.");
+
+    public:
+        using view_type = Kokkos::View<T*, MemorySpace,
+            Kokkos::MemoryTraits<Kokkos::Unmanaged>>;
+
+        ScratchView() = default;
+
+        explicit ScratchView(std::size_t n)
+          : view_(static_cast<T*>(
+                      n == 0 ? nullptr : arena().acquire(n * sizeof(T))),
+                n)
+          , owner_(n != 0)
+        {
+        }
+
+        KOKKOS_FUNCTION ScratchView(ScratchView const& other)
+          : view_(other.view_)
+        {
+        }
+
+        KOKKOS_FUNCTION ScratchView(ScratchView&& other)
+          : view_(other.view_)
+        {
+            KOKKOS_IF_ON_HOST((owner_ = other.owner_; other.owner_ = false;))
+        }
+
+        KOKKOS_FUNCTION ScratchView& operator=(ScratchView const& other)
+        {
+            KOKKOS_IF_ON_HOST((reset();))
+            view_ = other.view_;
+            return *this;
+        }
+
+        KOKKOS_FUNCTION ScratchView& operator=(ScratchView&& other)
+        {
+            KOKKOS_IF_ON_HOST((reset(); owner_ = other.owner_;
+                               other.owner_ = false;))
+            view_ = other.view_;
+            return *this;
+        }
+
+        KOKKOS_FUNCTION ~ScratchView()
+        {
+            KOKKOS_IF_ON_HOST((reset();))
+        }
+
+        KOKKOS_FORCEINLINE_FUNCTION T& operator()(std::size_t i) const
+        {
+            return view_(i);
+        }
+
+        KOKKOS_FUNCTION std::size_t extent(unsigned) const
+        {
+            return view_.extent(0);
+        }
+
+        view_type const& view() const noexcept
+        {
+            return view_;
+        }
+
+    private:
+        static ScratchArena<MemorySpace>& arena()
+        {
+            return ScratchArena<MemorySpace>::instance();
+        }
+
+        void reset()
+        {
+            if (owner_)
+                arena().release(view_.data(), view_.extent(0) * sizeof(T));
+            owner_ = false;
+        }
+
+        view_type view_;
+        bool owner_ = false;
+    };
+
+}}}    // namespace Kokkos::resilience::util
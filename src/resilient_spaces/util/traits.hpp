@@ -6,30 +6,161 @@
 
 #pragma once
 
+#include <Kokkos_Core.hpp>
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
 namespace Kokkos { namespace resilience { namespace traits {
 
+    // Resilient execution spaces expose the space they wrap and their
+    // validator type (void if there is none).
+    template <typename T, typename = void>
+    struct is_resilient_space : std::false_type
+    {
+    };
+
+    template <typename T>
+    struct is_resilient_space<T,
+        std::void_t<typename T::base_execution_space,
+            typename T::validator_type>> : std::true_type
+    {
+    };
+
+    // First resilient execution space among the policy traits, void if none.
+    template <typename... Traits>
+    struct find_resilient_space
+    {
+        using type = void;
+    };
+
+    template <typename Trait, typename... Traits>
+    struct find_resilient_space<Trait, Traits...>
+    {
+        using type = std::conditional_t<is_resilient_space<Trait>::value,
+            Trait, typename find_resilient_space<Traits...>::type>;
+    };
+
+    // Replaces the resilient execution space by the space it wraps, all
+    // other traits (IndexType, WorkTag, Schedule, Rank, ...) are kept in
+    // place.
+    template <typename Trait, bool = is_resilient_space<Trait>::value>
+    struct strip_resilience
+    {
+        using type = Trait;
+    };
+
+    template <typename Trait>
+    struct strip_resilience<Trait, true>
+    {
+        using type = typename Trait::base_execution_space;
+    };
+
     template <typename ExecutionSpace, typename... Traits>
-    struct RangePolicyExtracter
+    struct PolicyExtracterBase
     {
         using execution_space = ExecutionSpace;
         using base_execution_space =
             typename execution_space::base_execution_space;
+        using validator = typename execution_space::validator_type;
+    };
+
+    // Policies without a resilient execution space have no members, so the
+    // resilient specializations are silently discarded for them.
+    template <typename... Traits>
+    struct PolicyExtracterBase<void, Traits...>
+    {
+    };
 
+    template <typename... Traits>
+    struct RangePolicyExtracter
+      : PolicyExtracterBase<typename find_resilient_space<Traits...>::type,
+            Traits...>
+    {
         using RangePolicy =
-            Kokkos::RangePolicy<base_execution_space, Traits...>;
-        using validator = typename execution_space::validator_type;
+            Kokkos::RangePolicy<typename strip_resilience<Traits>::type...>;
     };
 
-    template <typename ExecutionSpace, typename... Traits>
+    template <typename... Traits>
     struct MDRangePolicyExtracter
+      : PolicyExtracterBase<typename find_resilient_space<Traits...>::type,
+            Traits...>
     {
-        using execution_space = ExecutionSpace;
-        using base_execution_space =
-            typename execution_space::base_execution_space;
-
         using MDRangePolicy =
-            Kokkos::MDRangePolicy<base_execution_space, Traits...>;
-        using validator = typename execution_space::validator_type;
+            Kokkos::MDRangePolicy<typename strip_resilience<Traits>::type...>;
+    };
+
+    // Validators may take the work tag of a tagged policy as first argument,
+    // otherwise the tag is dropped.
+    template <typename Validator, typename Tag, typename... Args>
+    KOKKOS_INLINE_FUNCTION bool invoke_validator_untagged(
+        Validator const& validator, Tag const&, Args&&... args)
+    {
+        return validator(static_cast<Args&&>(args)...);
+    }
+
+    template <typename Validator, typename... Args>
+    KOKKOS_INLINE_FUNCTION bool invoke_validator(
+        Validator const& validator, Args&&... args)
+    {
+        if constexpr (std::is_invocable_r<bool, Validator const&,
+                          Args&&...>::value)
+            return validator(static_cast<Args&&>(args)...);
+        else
+            return invoke_validator_untagged(
+                validator, static_cast<Args&&>(args)...);
+    }
+
+    // Calls the functor for index i, with the work tag if there is one.
+    template <typename WorkTag, typename Functor, typename... IndexType>
+    KOKKOS_FORCEINLINE_FUNCTION auto invoke_tagged(
+        Functor const& functor, IndexType... i)
+    {
+        if constexpr (std::is_void<WorkTag>::value)
+            return functor(i...);
+        else
+            return functor(WorkTag{}, i...);
+    }
+
+    // Type the functor returns for one index of a RangePolicy or an
+    // MDRangePolicy, void for kernels writing their results.
+    template <typename Functor, typename Policy>
+    struct kernel_result;
+
+    template <typename Functor, typename... Traits>
+    struct kernel_result<Functor, Kokkos::RangePolicy<Traits...>>
+    {
+        using policy = Kokkos::RangePolicy<Traits...>;
+        using type = decltype(invoke_tagged<typename policy::work_tag>(
+            std::declval<Functor const&>(),
+            std::declval<typename policy::index_type>()));
     };
 
+    template <typename Functor, typename... Traits>
+    struct kernel_result<Functor, Kokkos::MDRangePolicy<Traits...>>
+    {
+        using policy = Kokkos::MDRangePolicy<Traits...>;
+
+        template <std::size_t... I>
+        static auto invoke(std::index_sequence<I...>)
+            -> decltype(invoke_tagged<typename policy::work_tag>(
+                std::declval<Functor const&>(),
+                ((void) I, std::declval<typename policy::index_type>())...));
+
+        using type =
+            decltype(invoke(std::make_index_sequence<policy::rank>()));
+    };
+
+    // Validation of a reduction result, tagged if the policy is.
+    template <typename WorkTag, typename Validator, typename ValueType>
+    bool invoke_result_validator(
+        Validator const& validator, ValueType& result)
+    {
+        if constexpr (std::is_void<WorkTag>::value)
+            return validator(result);
+        else
+            return invoke_validator(validator, WorkTag{}, result);
+    }
+
 }}}    // namespace Kokkos::resilience::traits
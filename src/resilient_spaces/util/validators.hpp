@@ -0,0 +1,300 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <Kokkos_Core.hpp>
+
+#include <resilient_spaces/util/traits.hpp>
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+// Ready-made validators.
+//
+// Per-index validators are device callable and are invoked by the resilient
+// spaces with the indices of the iteration followed by the functor result.
+// They are branch-free comparisons, so they vectorize with the kernel they
+// validate.
+//
+// Block validators take no arguments and check a whole contiguous View with
+// a single fused reduction, enqueued on the execution space instance they
+// were constructed with. They are meant for ResilientTransaction groups.
+// They do not fit ResilientSpeculation, whose validators take the step
+// index, run on a separate thread and must not read state that later steps
+// may be writing.
+namespace Kokkos { namespace resilience { namespace validators {
+
+    namespace detail {
+
+        template <typename T>
+        KOKKOS_FORCEINLINE_FUNCTION T const& last(T const& t)
+        {
+            return t;
+        }
+
+        template <typename T, typename... Ts>
+        KOKKOS_FORCEINLINE_FUNCTION decltype(auto) last(
+            T const&, Ts const&... ts)
+        {
+            return last(ts...);
+        }
+
+        template <typename I>
+        using if_index = std::enable_if_t<std::is_integral<I>::value, int>;
+
+        // Applies the View to the indices, i.e. all arguments but the work
+        // tag and the result
+        template <typename ViewType, typename I, typename T,
+            if_index<I> = 0>
+        KOKKOS_FORCEINLINE_FUNCTION decltype(auto) at(
+            ViewType const& view, I i, T const&)
+        {
+            return view(i);
+        }
+
+        template <typename ViewType, typename I, typename J, typename T,
+            if_index<I> = 0>
+        KOKKOS_FORCEINLINE_FUNCTION decltype(auto) at(
+            ViewType const& view, I i, J j, T const&)
+        {
+            return view(i, j);
+        }
+
+        template <typename ViewType, typename I, typename J, typename K,
+            typename T, if_index<I> = 0>
+        KOKKOS_FORCEINLINE_FUNCTION decltype(auto) at(
+            ViewType const& view, I i, J j, K k, T const&)
+        {
+            return view(i, j, k);
+        }
+
+        template <typename ViewType, typename Tag, typename... Args,
+            std::enable_if_t<!std::is_integral<Tag>::value, int> = 0>
+        KOKKOS_FORCEINLINE_FUNCTION decltype(auto) at(
+            ViewType const& view, Tag const&, Args const&... args)
+        {
+            return at(view, args...);
+        }
+
+        // Block validators reduce over the span of the View
+        template <typename ViewType>
+        void require_contiguous(ViewType const& view)
+        {
+            if (!view.span_is_contiguous())
+                throw std::runtime_error(
+                    "Block validators require a contiguous View.");
+        }
+
+    }    // namespace detail
+
+    // Rejects NaN and infinite results.
+    struct finite
+    {
+        template <typename... Args>
+        KOKKOS_FUNCTION bool operator()(Args const&... args) const
+        {
+            return Kokkos::isfinite(detail::last(args...));
+        }
+    };
+
+    // Accepts results in [lower, upper], NaN is rejected.
+    template <typename T>
+    struct bounds
+    {
+        template <typename... Args>
+        KOKKOS_FUNCTION bool operator()(Args const&... args) const
+        {
+            auto const& result = detail::last(args...);
+            return result >= lower && result <= upper;
+        }
+
+        T lower;
+        T upper;
+    };
+
+    // Accepts results not decreasing (or not increasing) with respect to
+    // the previous value of the same index, e.g. a quantity growing over
+    // the timesteps.
+    template <typename ViewType>
+    struct monotonic
+    {
+        template <typename... Args>
+        KOKKOS_FUNCTION bool operator()(Args const&... args) const
+        {
+            auto const& result = detail::last(args...);
+            auto const& before = detail::at(previous, args...);
+            return increasing ? result >= before : result <= before;
+        }
+
+        ViewType previous;
+        bool increasing = true;
+    };
+
+    // Accepts results within a relative distance of a reference solution,
+    // |result - reference| <= tolerance * |reference|.
+    template <typename ViewType>
+    struct relative_residual
+    {
+        template <typename... Args>
+        KOKKOS_FUNCTION bool operator()(Args const&... args) const
+        {
+            auto const& result = detail::last(args...);
+            auto const& expected = detail::at(reference, args...);
+            return Kokkos::abs(result - expected) <=
+                tolerance * Kokkos::abs(expected);
+        }
+
+        ViewType reference;
+        double tolerance;
+    };
+
+    // Fuses per-index validators, all of them must accept the result.
+    template <typename... Validators>
+    struct all_of;
+
+    template <>
+    struct all_of<>
+    {
+        template <typename... Args>
+        KOKKOS_FUNCTION bool operator()(Args const&...) const
+        {
+            return true;
+        }
+    };
+
+    template <typename Validator, typename... Validators>
+    struct all_of<Validator, Validators...>
+    {
+        template <typename... Args>
+        KOKKOS_FUNCTION bool operator()(Args const&... args) const
+        {
+            // Both sides are evaluated to keep the check branch-free
+            return traits::invoke_validator(first, args...) &
+                rest(args...);
+        }
+
+        Validator first;
+        all_of<Validators...> rest;
+    };
+
+    template <typename... Validators>
+    all_of<Validators...> all(Validators const&... validators)
+    {
+        return {validators...};
+    }
+
+    // Block validator: applies a per-index validator to every element of a
+    // contiguous View in one reduction. Elements are passed with their
+    // linear index, so validators referencing a View must use a View of the
+    // same shape flattened to rank 1.
+    template <typename ViewType, typename Validator>
+    class block
+    {
+    public:
+        using execution_space = typename ViewType::execution_space;
+
+        block(ViewType const& view, Validator const& validator,
+            execution_space const& space = execution_space{})
+          : view_(view)
+          , validator_(validator)
+          , space_(space)
+        {
+            detail::require_contiguous(view_);
+        }
+
+        bool operator()() const
+        {
+            return failures() == 0;
+        }
+
+        // Number of rejected elements
+        std::size_t failures() const
+        {
+            auto const data = view_.data();
+            Validator const validator = validator_;
+
+            std::size_t failures = 0;
+            Kokkos::parallel_reduce("krs_block_validator",
+                Kokkos::RangePolicy<execution_space>(space_, 0, view_.span()),
+                KOKKOS_LAMBDA(std::size_t k, std::size_t & count) {
+                    count += !traits::invoke_validator(validator, k, data[k]);
+                },
+                failures);
+            return failures;
+        }
+
+    private:
+        ViewType view_;
+        Validator validator_;
+        execution_space space_;
+    };
+
+    template <typename ViewType, typename Validator>
+    block<ViewType, Validator> make_block(ViewType const& view,
+        Validator const& validator,
+        typename ViewType::execution_space const& space =
+            typename ViewType::execution_space{})
+    {
+        return block<ViewType, Validator>(view, validator, space);
+    }
+
+    // Block validator: the sum of all elements of a View must match the
+    // expected total within a relative tolerance (mass, energy, ABFT
+    // checksums, ...).
+    template <typename ViewType>
+    class conservation
+    {
+    public:
+        using execution_space = typename ViewType::execution_space;
+        using value_type = typename ViewType::non_const_value_type;
+
+        conservation(ViewType const& view, value_type expected,
+            double tolerance = 1e-10,
+            execution_space const& space = execution_space{})
+          : view_(view)
+          , expected_(expected)
+          , tolerance_(tolerance)
+          , space_(space)
+        {
+            detail::require_contiguous(view_);
+        }
+
+        bool operator()() const
+        {
+            value_type const total = sum();
+            return Kokkos::abs(total - expected_) <=
+                tolerance_ * Kokkos::abs(expected_);
+        }
+
+        value_type sum() const
+        {
+            auto const data = view_.data();
+
+            value_type total{};
+            Kokkos::parallel_reduce("krs_conservation_validator",
+                Kokkos::RangePolicy<execution_space>(space_, 0, view_.span()),
+                KOKKOS_LAMBDA(std::size_t k, value_type & partial) {
+                    partial += data[k];
+                },
+                total);
+            return total;
+        }
+
+        void set_expected(value_type expected) noexcept
+        {
+            expected_ = expected;
+        }
+
+    private:
+        ViewType view_;
+        value_type expected_;
+        double tolerance_;
+        execution_space space_;
+    };
+
+}}}    // namespace Kokkos::resilience::validators
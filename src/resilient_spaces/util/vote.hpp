@@ -0,0 +1,203 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <Kokkos_Core.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Comparison and voting of replica results.
+//
+// Arithmetic results compare with operator==. Kokkos::Array, simd and other
+// trivially copyable results compare lane by lane on their object
+// representation, so they need no operator== and NaNs agree with
+// themselves. Lanes are the elements for types with an arithmetic
+// value_type (Kokkos::Array, Kokkos::Experimental::simd), otherwise words
+// of the alignment of the type, at most 8 bytes. The lane loops have a
+// fixed trip count and no branches and compile to SIMD compares. Padding
+// of structs must be deterministic, e.g. structs without padding.
+namespace Kokkos { namespace resilience { namespace util {
+
+    namespace detail {
+
+        template <std::size_t Bytes>
+        struct unsigned_lane;
+
+        template <>
+        struct unsigned_lane<1>
+        {
+            using type = std::uint8_t;
+        };
+
+        template <>
+        struct unsigned_lane<2>
+        {
+            using type = std::uint16_t;
+        };
+
+        template <>
+        struct unsigned_lane<4>
+        {
+            using type = std::uint32_t;
+        };
+
+        template <>
+        struct unsigned_lane<8>
+        {
+            using type = std::uint64_t;
+        };
+
+        template <typename T>
+        constexpr std::size_t word_bytes = alignof(T) < 8 ? alignof(T) : 8;
+
+        template <typename T, typename = void>
+        struct lane_bytes : std::integral_constant<std::size_t, word_bytes<T>>
+        {
+        };
+
+        template <typename T>
+        struct lane_bytes<T, std::void_t<typename T::value_type>>
+          : std::integral_constant<std::size_t,
+                std::is_arithmetic<typename T::value_type>::value &&
+                        sizeof(typename T::value_type) <= 8 &&
+                        sizeof(T) % sizeof(typename T::value_type) == 0 ?
+                    sizeof(typename T::value_type) :
+                    word_bytes<T>>
+        {
+        };
+
+        template <typename T>
+        struct lanes
+        {
+            using lane_type =
+                typename unsigned_lane<lane_bytes<T>::value>::type;
+            static constexpr std::size_t count = sizeof(T) / sizeof(lane_type);
+
+            KOKKOS_FORCEINLINE_FUNCTION explicit lanes(T const& value)
+            {
+                std::memcpy(data, &value, sizeof(T));
+            }
+
+            lane_type data[count];
+        };
+
+        template <typename T>
+        constexpr bool is_lanewise = !std::is_arithmetic<T>::value &&
+            std::is_trivially_copyable<T>::value;
+
+    }    // namespace detail
+
+    template <typename T>
+    KOKKOS_INLINE_FUNCTION bool equal(T const& a, T const& b)
+    {
+        if constexpr (detail::is_lanewise<T>)
+        {
+            detail::lanes<T> const x(a);
+            detail::lanes<T> const y(b);
+
+            typename detail::lanes<T>::lane_type differ = 0;
+            for (std::size_t k = 0; k != detail::lanes<T>::count; ++k)
+                differ |= x.data[k] ^ y.data[k];
+            return differ == 0;
+        }
+        else
+        {
+            return a == b;
+        }
+    }
+
+    // True if every lane of c equals the lane of a or b, i.e. c is the
+    // majority of the three.
+    template <typename T>
+    KOKKOS_INLINE_FUNCTION bool agrees(T const& c, T const& a, T const& b)
+    {
+        if constexpr (detail::is_lanewise<T>)
+        {
+            detail::lanes<T> const x(a);
+            detail::lanes<T> const y(b);
+            detail::lanes<T> const z(c);
+
+            using lane_type = typename detail::lanes<T>::lane_type;
+
+            // Flags of the lane width keep the loop vectorizable
+            lane_type disagree = 0;
+            for (std::size_t k = 0; k != detail::lanes<T>::count; ++k)
+            {
+                disagree |= lane_type(z.data[k] != x.data[k]) &
+                    lane_type(z.data[k] != y.data[k]);
+            }
+            return disagree == 0;
+        }
+        else
+        {
+            return c == a || c == b;
+        }
+    }
+
+    // Per-lane majority of three results. Returns false if the replicas
+    // disagree pairwise in some lane, the lane of result is unspecified.
+    template <typename T>
+    KOKKOS_INLINE_FUNCTION bool majority(
+        T const& a, T const& b, T const& c, T& result)
+    {
+        if constexpr (detail::is_lanewise<T>)
+        {
+            detail::lanes<T> const x(a);
+            detail::lanes<T> const y(b);
+            detail::lanes<T> const z(c);
+            detail::lanes<T> vote(a);
+
+            using lane_type = typename detail::lanes<T>::lane_type;
+
+            // Bitwise majority is the majority of every lane that has one
+            lane_type none = 0;
+            for (std::size_t k = 0; k != detail::lanes<T>::count; ++k)
+            {
+                vote.data[k] = (x.data[k] & y.data[k]) |
+                    (x.data[k] & z.data[k]) | (y.data[k] & z.data[k]);
+                none |= lane_type(x.data[k] != y.data[k]) &
+                    lane_type(x.data[k] != z.data[k]) &
+                    lane_type(y.data[k] != z.data[k]);
+            }
+
+            std::memcpy(&result, vote.data, sizeof(T));
+            return none == 0;
+        }
+        else
+        {
+            bool const found = a == b || a == c || b == c;
+            result = a == b || a == c ? a : b;
+            return found;
+        }
+    }
+
+    // True if the result of a replica in lower precision agrees with the
+    // result, |result - shadow| <= relative * |result| + absolute, in
+    // every element of array results.
+    template <typename T, typename Shadow>
+    KOKKOS_INLINE_FUNCTION bool within(T const& result, Shadow const& shadow,
+        double relative, double absolute)
+    {
+        if constexpr (std::is_arithmetic<T>::value)
+        {
+            double const r = double(result);
+            return Kokkos::abs(r - double(shadow)) <=
+                relative * Kokkos::abs(r) + absolute;
+        }
+        else
+        {
+            bool inside = true;
+            for (std::size_t k = 0; k != result.size(); ++k)
+                inside &= within(result[k], shadow[k], relative, absolute);
+            return inside;
+        }
+    }
+
+}}}    // namespace Kokkos::resilience::util
@@ -0,0 +1,79 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <resilient_spaces/resilient_spaces.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <iostream>
+
+using space = Kokkos::DefaultExecutionSpace;
+using accumulator_type = Kokkos::resilience::util::Accumulator<long, space>;
+
+// Rejects the first group, accepts once the accumulated value is correct.
+struct validator
+{
+    bool operator()() const
+    {
+        calls() += 1;
+        return calls() > 1 && sum.value() == expected;
+    }
+
+    accumulator_type sum;
+    Kokkos::View<int, Kokkos::HostSpace> calls;
+    long expected;
+};
+
+int main(int argc, char* argv[])
+{
+    Kokkos::initialize(argc, argv);
+
+    bool success = true;
+    {
+        using replay_space =
+            Kokkos::resilience::ResilientReplay<space, validator>;
+        using range_policy = Kokkos::RangePolicy<space>;
+
+        long const n = 10000;
+        space inst{};
+
+        accumulator_type sum("sum", inst);
+        sum.set(5);
+
+        Kokkos::parallel_for(
+            "contribute", range_policy(inst, 0, n),
+            KOKKOS_LAMBDA(long i) { sum.add(i); });
+        sum.commit();
+
+        long const expected = 5 + n * (n - 1) / 2;
+        success = success && sum.value() == expected;
+
+        // Contributions of the rejected attempt must not be counted twice
+        Kokkos::View<int, Kokkos::HostSpace> calls("calls");
+        Kokkos::resilience::ResilientTransaction<space, validator> tx(
+            replay_space(3, validator{sum, calls, expected - n}, inst));
+
+        tx.enlist(sum);
+        tx.parallel_for("subtract", range_policy(inst, 0, n),
+            KOKKOS_LAMBDA(long) { sum.add(-1); });
+        tx.execute();
+
+        success = success && calls() == 2 && sum.value() == expected - n;
+
+        // Discarded contributions
+        Kokkos::parallel_for(
+            "discarded", range_policy(inst, 0, n),
+            KOKKOS_LAMBDA(long) { sum.add(1); });
+        sum.restore();
+        success = success && sum.value() == expected - n;
+
+        std::cout << "Execution Complete" << std::endl;
+    }
+
+    Kokkos::finalize();
+
+    return success ? 0 : 1;
+}
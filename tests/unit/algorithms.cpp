@@ -0,0 +1,124 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <resilient_spaces/algorithms/algorithms.hpp>
+#include <resilient_spaces/resilient_spaces.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cmath>
+#include <iostream>
+
+using space = Kokkos::DefaultExecutionSpace;
+using view_type = Kokkos::View<int*, space>;
+
+namespace algorithms = Kokkos::resilience::algorithms;
+
+struct validator
+{
+    template <typename... Args>
+    KOKKOS_FUNCTION bool operator()(Args const&...) const
+    {
+        return true;
+    }
+};
+
+// Returns a wrong value on call `faulty`
+struct square
+{
+    KOKKOS_FUNCTION int operator()(int x) const
+    {
+        int const call = Kokkos::atomic_fetch_add(&calls(), 1);
+        return call == faulty ? -1 : x * x;
+    }
+
+    Kokkos::View<int, space> calls;
+    int faulty;
+};
+
+// Selects even values, wrongly selects an odd one on call `faulty`
+struct even
+{
+    KOKKOS_FUNCTION bool operator()(int x) const
+    {
+        int const call = Kokkos::atomic_fetch_add(&calls(), 1);
+        return call == faulty || x % 2 == 0;
+    }
+
+    Kokkos::View<int, space> calls;
+    int faulty;
+};
+
+int main(int argc, char* argv[])
+{
+    Kokkos::initialize(argc, argv);
+
+    bool success = true;
+    {
+        using replay = Kokkos::resilience::ResilientReplay<space, validator>;
+        using replicate = Kokkos::resilience::ResilientReplicate<space>;
+
+        int const n = 1000;
+        space inst{};
+        replay const resilient(3, validator{}, inst);
+
+        view_type data("data", n);
+        view_type result("result", n);
+        Kokkos::View<int, space> calls("calls");
+
+        // Values n - 1, ..., 0
+        Kokkos::parallel_for(
+            "init", Kokkos::RangePolicy<space>(inst, 0, n),
+            KOKKOS_LAMBDA(int i) { data(i) = n - 1 - i; });
+
+        // A faulty output is detected by the verification pass
+        algorithms::transform(resilient, data, result, square{calls, 7});
+
+        auto hresult =
+            Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, result);
+        for (int i = 0; i != n; ++i)
+            success = success && hresult(i) == (n - 1 - i) * (n - 1 - i);
+
+        success = success &&
+            algorithms::reduce(replicate(inst), data, 0) == n * (n - 1) / 2;
+
+        // Floating point sums, a NaN propagates to value and shadow
+        Kokkos::View<double*, space> reals("reals", n);
+        Kokkos::parallel_for(
+            "init_reals", Kokkos::RangePolicy<space>(inst, 0, n),
+            KOKKOS_LAMBDA(int i) { reals(i) = 0.1 * i - 3.; });
+        double const sum = algorithms::reduce(resilient, reals, 0.5);
+        success = success &&
+            std::abs(sum - (0.5 + 0.05 * n * (n - 1) - 3. * n)) < 1e-9 * n;
+
+        Kokkos::deep_copy(Kokkos::subview(reals, 3), std::nan(""));
+        double const nan = algorithms::reduce(resilient, reals, 0.);
+        success = success && nan != nan;
+
+        // A wrongly selected value is detected
+        Kokkos::deep_copy(calls, 0);
+        std::size_t const count =
+            algorithms::copy_if(resilient, data, result, even{calls, 1});
+
+        Kokkos::deep_copy(hresult, result);
+        success = success && count == std::size_t(n / 2);
+        for (std::size_t i = 0; i != count; ++i)
+            success = success && hresult(i) % 2 == 0;
+
+        algorithms::sort(resilient, data);
+
+        auto hdata =
+            Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, data);
+        for (int i = 0; i != n; ++i)
+            success = success && hdata(i) == i;
+
+        std::cout << "Execution Complete" << std::endl;
+    }
+
+    Kokkos::finalize();
+
+    return success ? 0 : 1;
+}
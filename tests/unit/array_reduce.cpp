@@ -0,0 +1,138 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <resilient_spaces/resilient_spaces.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cstddef>
+#include <iostream>
+
+using space = Kokkos::DefaultExecutionSpace;
+
+int const n = 100;
+
+struct minmax_value
+{
+    int min;
+    int max;
+};
+
+// Rejects the first result of every reduction
+struct validator
+{
+    bool first() const
+    {
+        calls() += 1;
+        return calls() == 1;
+    }
+
+    // Array reductions are validated once with all values
+    bool operator()(long const* values) const
+    {
+        return !first() && values[0] == n && values[1] == n * (n - 1) / 2 &&
+            values[2] == n * (n - 1) * (2 * n - 1) / 6;
+    }
+
+    bool operator()(minmax_value const& value) const
+    {
+        return !first() && value.min == 0 && value.max == n - 1;
+    }
+
+    Kokkos::View<int, Kokkos::HostSpace> calls;
+};
+
+// Count, sum and sum of squares
+struct moments
+{
+    using value_type = long[];
+    using size_type = std::size_t;
+
+    KOKKOS_FUNCTION void operator()(int i, long* values) const
+    {
+        values[0] += 1;
+        values[1] += i;
+        values[2] += long(i) * i;
+    }
+
+    std::size_t value_count = 3;
+};
+
+// Custom reducer on a struct value type
+struct minmax
+{
+    using reducer = minmax;
+    using value_type = minmax_value;
+    using result_view_type = Kokkos::View<value_type, Kokkos::HostSpace>;
+
+    KOKKOS_FUNCTION void join(value_type& dst, value_type const& src) const
+    {
+        dst.min = src.min < dst.min ? src.min : dst.min;
+        dst.max = src.max > dst.max ? src.max : dst.max;
+    }
+
+    KOKKOS_FUNCTION void init(value_type& value) const
+    {
+        value.min = n;
+        value.max = -1;
+    }
+
+    value_type& reference() const
+    {
+        return *m_view.data();
+    }
+
+    result_view_type view() const
+    {
+        return m_view;
+    }
+
+    result_view_type m_view;
+};
+
+int main(int argc, char* argv[])
+{
+    Kokkos::initialize(argc, argv);
+
+    bool success = true;
+    {
+        using replay = Kokkos::resilience::ResilientReplay<space, validator>;
+        using range_policy = Kokkos::RangePolicy<replay>;
+
+        space inst{};
+        Kokkos::View<int, Kokkos::HostSpace> calls("calls");
+
+        // All values of an array reduction into a View
+        Kokkos::View<long[3], space> result("result");
+        Kokkos::parallel_reduce(
+            range_policy(replay(3, validator{calls}, inst), 0, n), moments{},
+            result);
+
+        auto host =
+            Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, result);
+        success = success && calls() == 2 && host(0) == n &&
+            host(1) == n * (n - 1) / 2;
+
+        // Struct value type with a custom reducer
+        calls() = 0;
+        minmax_value extrema{};
+        Kokkos::parallel_reduce(
+            range_policy(replay(3, validator{calls}, inst), 0, n),
+            KOKKOS_LAMBDA(int i, minmax_value& value) {
+                value.min = i < value.min ? i : value.min;
+                value.max = i > value.max ? i : value.max;
+            },
+            minmax{minmax::result_view_type(&extrema)});
+        success = success && calls() == 2 && extrema.min == 0 &&
+            extrema.max == n - 1;
+
+        std::cout << "Execution Complete" << std::endl;
+    }
+
+    Kokkos::finalize();
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <resilient_spaces/resilient_spaces.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <iostream>
+#include <stdexcept>
+
+using space = Kokkos::DefaultHostExecutionSpace;
+using view_type = Kokkos::View<int*, space>;
+using view_2d_type = Kokkos::View<double**, space>;
+using captured_type = Kokkos::resilience::util::CapturedView<view_type>;
+
+// Void kernel, the first `faults` executions of each index write a wrong
+// value. Attempts are counted outside the captured View.
+struct operation
+{
+    KOKKOS_FUNCTION void operator()(int i) const
+    {
+        int const attempt = attempts(i)++;
+        data(i) += attempt < faults ? -attempt - 1 : 2 * i;
+    }
+
+    captured_type data;
+    view_type attempts;
+    int faults;
+};
+
+// Writes more elements than the write log holds
+struct spray
+{
+    KOKKOS_FUNCTION void operator()(int i) const
+    {
+        for (int k = 0; k != 64; ++k)
+            data(k) = i;
+    }
+
+    captured_type data;
+};
+
+int main(int argc, char* argv[])
+{
+    Kokkos::initialize(argc, argv);
+
+    bool success = true;
+    {
+        using replicate = Kokkos::resilience::ResilientReplicate<space>;
+        using range_policy = Kokkos::RangePolicy<replicate>;
+        using mdrange_policy =
+            Kokkos::MDRangePolicy<replicate, Kokkos::Rank<2>>;
+
+        namespace util = Kokkos::resilience::util;
+
+        int const n = 1000;
+        space inst{};
+
+        view_type data("data", n);
+        view_type attempts("attempts", n);
+
+        // Agreeing replicas, the update is applied once
+        Kokkos::parallel_for(range_policy(replicate(inst), 0, n),
+            operation{util::capture(data), attempts, 0});
+        Kokkos::fence();
+
+        for (int i = 0; i != n; ++i)
+            success = success && attempts(i) == 2 && data(i) == 2 * i;
+
+        // A faulty first replica is outvoted by the third
+        Kokkos::deep_copy(data, 0);
+        Kokkos::deep_copy(attempts, 0);
+        Kokkos::parallel_for(range_policy(replicate(inst), 0, n),
+            operation{util::capture(data), attempts, 1});
+        Kokkos::fence();
+
+        for (int i = 0; i != n; ++i)
+            success = success && attempts(i) == 3 && data(i) == 2 * i;
+
+        // Three different results
+        Kokkos::deep_copy(attempts, 0);
+        bool caught = false;
+        try
+        {
+            Kokkos::parallel_for(range_policy(replicate(inst), 0, n),
+                operation{util::capture(data), attempts, 3});
+        }
+        catch (std::runtime_error const&)
+        {
+            caught = true;
+        }
+        success = success && caught;
+
+        // Too many elements per iteration
+        caught = false;
+        try
+        {
+            Kokkos::parallel_for(range_policy(replicate(inst), 0, 10),
+                spray{util::capture(data)});
+        }
+        catch (std::runtime_error const&)
+        {
+            caught = true;
+        }
+        success = success && caught;
+
+        // Unmodified lambda on an MDRangePolicy
+        view_2d_type grid("grid", 10, 20);
+        auto const captured = util::capture(grid);
+        Kokkos::parallel_for(
+            mdrange_policy(replicate(inst), {0, 0}, {10, 20}),
+            KOKKOS_LAMBDA(int i, int j) { captured(i, j) = 0.5 * i * j; });
+        Kokkos::fence();
+
+        for (int i = 0; i != 10; ++i)
+        {
+            for (int j = 0; j != 20; ++j)
+                success = success && grid(i, j) == 0.5 * i * j;
+        }
+
+        // Outside replicas accesses are direct
+        captured(1, 1) = 3.;
+        success = success && grid(1, 1) == 3.;
+
+        std::cout << "Execution Complete" << std::endl;
+    }
+
+    Kokkos::finalize();
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,130 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <resilient_spaces/checkpoint/checkpoint.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+template <typename ViewType>
+bool equal(ViewType const& a, ViewType const& b)
+{
+    auto ha = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, a);
+    auto hb = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, b);
+
+    for (std::size_t i = 0; i != ha.span(); ++i)
+    {
+        if (ha.data()[i] != hb.data()[i])
+            return false;
+    }
+    return true;
+}
+
+// Overwrites the 8 bytes at offset (from the end if negative) and checks
+// that restoring the View fails instead of reading out of bounds.
+template <typename ViewType>
+bool rejects_patch(std::string const& path, std::string const& copy,
+    ViewType const& view, std::streamoff offset, std::uint64_t value)
+{
+    {
+        std::ifstream src(path, std::ios::binary);
+        std::ofstream dst(copy, std::ios::binary | std::ios::trunc);
+        dst << src.rdbuf();
+        dst.seekp(offset, offset < 0 ? std::ios::end : std::ios::beg);
+        dst.write(reinterpret_cast<char const*>(&value), sizeof(value));
+    }
+
+    bool rejected = false;
+    try
+    {
+        Kokkos::resilience::checkpoint::read(copy, view);
+    }
+    catch (std::runtime_error const&)
+    {
+        rejected = true;
+    }
+    std::remove(copy.c_str());
+    return rejected;
+}
+
+int main(int argc, char* argv[])
+{
+    Kokkos::initialize(argc, argv);
+
+    bool success = true;
+    {
+        std::string const path = "krs_checkpoint_test.bin";
+        std::size_t const n = 1000;
+        std::size_t const block_values = 128;
+
+        Kokkos::View<double**> field("field", n, 3);
+        Kokkos::View<double**> restored("restored", n, 3);
+
+        Kokkos::parallel_for(
+            "init", Kokkos::RangePolicy<>(0, n), KOKKOS_LAMBDA(int i) {
+                field(i, 0) = 0.;
+                field(i, 1) = std::sin(0.01 * i);
+                field(i, 2) = 100. * i;
+            });
+        Kokkos::fence();
+
+        auto stats =
+            Kokkos::resilience::checkpoint::write(path, field, block_values);
+
+        std::cout << "[Ratio]: " << stats.ratio() << std::endl;
+
+        // Full restart
+        Kokkos::resilience::checkpoint::read(path, restored);
+        success = success && equal(field, restored);
+
+        // Partial restart of every block, one at a time
+        Kokkos::deep_copy(restored, 0.);
+        std::size_t const blocks =
+            Kokkos::resilience::checkpoint::block_count(path);
+        for (std::size_t b = 0; b != blocks; ++b)
+            Kokkos::resilience::checkpoint::read_block(path, restored, b);
+        success = success && equal(field, restored);
+
+        // Corrupted index entries and trailers, offsets from the end of
+        // the file: trailer blocks -24, trailer index offset -16, offset
+        // and bytes of the last index entry -56 and -48
+        std::string const corrupt = "krs_checkpoint_corrupt.bin";
+        success = success &&
+            rejects_patch(path, corrupt, restored, -24, std::uint64_t(1) << 40);
+        success = success && rejects_patch(path, corrupt, restored, -16, 0);
+        success = success &&
+            rejects_patch(path, corrupt, restored, -56, std::uint64_t(-8));
+        success = success &&
+            rejects_patch(path, corrupt, restored, -48, std::uint64_t(1) << 40);
+
+        // Single precision
+        Kokkos::View<float*> small("small", 77);
+        Kokkos::View<float*> small_restored("small_restored", 77);
+        Kokkos::parallel_for(
+            "init_small", Kokkos::RangePolicy<>(0, 77),
+            KOKKOS_LAMBDA(int i) { small(i) = 0.5f * i; });
+        Kokkos::fence();
+
+        Kokkos::resilience::checkpoint::write(path, small);
+        Kokkos::resilience::checkpoint::read(path, small_restored);
+        success = success && equal(small, small_restored);
+
+        std::remove(path.c_str());
+
+        std::cout << "Execution Complete" << std::endl;
+    }
+
+    Kokkos::finalize();
+
+    return success ? 0 : 1;
+}
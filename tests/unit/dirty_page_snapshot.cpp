@@ -0,0 +1,122 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <resilient_spaces/resilient_spaces.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+using view_type = Kokkos::View<int*, Kokkos::HostSpace>;
+
+// Rejects the very first result, forcing the kernel to be replayed.
+struct validator
+{
+    KOKKOS_FUNCTION bool operator()(int, int) const
+    {
+        return Kokkos::atomic_fetch_add(&calls(0), 1) != 0;
+    }
+
+    KOKKOS_FUNCTION bool operator()(int const&) const
+    {
+        return Kokkos::atomic_fetch_add(&calls(0), 1) != 0;
+    }
+
+    view_type calls;
+};
+
+struct increment
+{
+    KOKKOS_FUNCTION int operator()(int i) const
+    {
+        data(i) += 1;
+        return data(i);
+    }
+
+    view_type data;
+};
+
+struct increment_reduce
+{
+    KOKKOS_FUNCTION void operator()(int i, int& sum) const
+    {
+        data(i) += 1;
+        sum += data(i);
+    }
+
+    view_type data;
+};
+
+int main(int argc, char* argv[])
+{
+    Kokkos::initialize(argc, argv);
+
+    bool success = true;
+    {
+        using space = Kokkos::DefaultHostExecutionSpace;
+        using replay_space =
+            Kokkos::resilience::ResilientReplay<space, validator>;
+
+        std::size_t const n = 100000;
+        view_type data("data", n);
+        view_type calls("calls", 1);
+
+        Kokkos::resilience::snapshot::DirtyPageTracker tracker;
+        tracker.register_view(data);
+
+        replay_space replay_inst(3, validator{calls}, space{});
+        replay_inst.set_snapshot(&tracker);
+
+        // In-place update, a replay without rollback would increment twice
+        Kokkos::parallel_for(
+            Kokkos::RangePolicy<replay_space>(replay_inst, 0, n),
+            increment{data});
+        Kokkos::fence();
+
+        for (std::size_t i = 0; i != n; ++i)
+            success = success && data(i) == 1;
+
+        calls(0) = 0;
+
+        int sum = 0;
+        Kokkos::parallel_reduce(
+            Kokkos::RangePolicy<replay_space>(replay_inst, 0, n),
+            increment_reduce{data}, Kokkos::Sum<int, space>(sum));
+
+        success = success && sum == int(2 * n);
+        for (std::size_t i = 0; i != n; ++i)
+            success = success && data(i) == 2;
+
+        // Only the pages written by the last attempt are tracked
+        std::size_t const page = Kokkos::resilience::snapshot::detail::
+            page_size();
+        std::size_t const m = 3 * page / sizeof(int) / 2;
+
+        calls(0) = 0;
+        Kokkos::parallel_for(
+            Kokkos::RangePolicy<replay_space>(replay_inst, 0, m),
+            increment{data});
+        Kokkos::fence();
+
+        std::uintptr_t const first =
+            reinterpret_cast<std::uintptr_t>(data.data());
+        std::uintptr_t const last = first + m * sizeof(int) - 1;
+        std::size_t const written = last / page - first / page + 1;
+
+        std::cout << "[Dirty pages]: " << tracker.dirty_pages() << std::endl;
+        success = success && tracker.dirty_pages() == written;
+        for (std::size_t i = 0; i != n; ++i)
+            success = success && data(i) == (i < m ? 3 : 2);
+
+        std::cout << "Execution Complete" << std::endl;
+    }
+
+    Kokkos::finalize();
+
+    return success ? 0 : 1;
+}
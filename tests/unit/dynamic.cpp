@@ -0,0 +1,171 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <resilient_spaces/resilient_spaces.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+using space = Kokkos::DefaultHostExecutionSpace;
+using view_type = Kokkos::View<int*, space>;
+
+// Counts the evaluations of each index, the first `faults` are wrong
+struct operation
+{
+    KOKKOS_FUNCTION int operator()(int i) const
+    {
+        int const attempt = Kokkos::atomic_fetch_add(&attempts(i), 1);
+        data(i) = 2 * i;
+        return attempt < faults ? -attempt - 1 : data(i);
+    }
+
+    view_type data;
+    view_type attempts;
+    int faults;
+};
+
+struct validator
+{
+    KOKKOS_FUNCTION bool operator()(int i, int result) const
+    {
+        return result == 2 * i;
+    }
+
+    KOKKOS_FUNCTION bool operator()(int i, int, int result) const
+    {
+        return result == 2 * i;
+    }
+};
+
+bool evaluated(view_type const& attempts, int count)
+{
+    Kokkos::fence();
+
+    bool success = true;
+    for (int i = 0; i != int(attempts.extent(0)); ++i)
+        success = success && attempts(i) == count;
+
+    Kokkos::deep_copy(attempts, 0);
+    return success;
+}
+
+int main(int argc, char* argv[])
+{
+    // Read on the first lookup
+    setenv("KRS_RESILIENCE",
+        "plain=none; checked = replay:4, voted=replicate # comment\n"
+        "counted=replicate:5\n*=replicate:2",
+        1);
+
+    Kokkos::initialize(argc, argv);
+
+    bool success = true;
+    {
+        using dynamic = Kokkos::resilience::ResilientDynamic<space>;
+        using validated =
+            Kokkos::resilience::ResilientDynamic<space, validator>;
+
+        int const n = 1000;
+        space inst{};
+
+        view_type data("data", n);
+        view_type attempts("attempts", n);
+
+        Kokkos::parallel_for(
+            Kokkos::RangePolicy<dynamic>(dynamic("plain", inst), 0, n),
+            operation{data, attempts, 0});
+        success = success && evaluated(attempts, 1);
+
+        // Replays until the validator accepts
+        validated const checked("checked", validator{}, inst);
+        Kokkos::parallel_for(Kokkos::RangePolicy<validated>(checked, 0, n),
+            operation{data, attempts, 3});
+        success = success && evaluated(attempts, 4);
+
+        // Majority vote of three
+        Kokkos::parallel_for(
+            Kokkos::RangePolicy<dynamic>(dynamic("voted", inst), 0, n),
+            operation{data, attempts, 1});
+        success = success && evaluated(attempts, 3);
+
+        // Default entry, validated replicates
+        Kokkos::parallel_for(
+            Kokkos::MDRangePolicy<validated, Kokkos::Rank<2>>(
+                validated("unknown", validator{}, inst), {0, 0}, {n, 1}),
+            KOKKOS_LAMBDA(int i, int) {
+                return operation{data, attempts, 0}(i);
+            });
+        success = success && evaluated(attempts, 2);
+
+        // Kernels writing their results can be launched on validated spaces,
+        // where they only run unprotected
+        auto const write = KOKKOS_LAMBDA(int i)
+        {
+            Kokkos::atomic_fetch_add(&attempts(i), 1);
+            data(i) = 2 * i;
+        };
+
+        Kokkos::parallel_for(Kokkos::RangePolicy<validated>(
+                                 validated("plain", validator{}, inst), 0, n),
+            write);
+        success = success && evaluated(attempts, 1);
+
+        bool thrown = false;
+        try
+        {
+            Kokkos::parallel_for(
+                Kokkos::RangePolicy<validated>(checked, 0, n), write);
+        }
+        catch (std::runtime_error const&)
+        {
+            thrown = true;
+        }
+        success = success && thrown && evaluated(attempts, 0);
+
+        // Replay without validator and vote counts are rejected
+        for (std::string const label : {"checked", "counted"})
+        {
+            thrown = false;
+            try
+            {
+                dynamic(label, inst);
+            }
+            catch (std::runtime_error const&)
+            {
+                thrown = true;
+            }
+            success = success && thrown;
+        }
+
+        // Malformed specifications
+        for (std::string const spec : {"a=redo", "a", "a=replay:x", "a=none:2"})
+        {
+            std::map<std::string, Kokkos::resilience::util::StrategyEntry>
+                entries;
+            thrown = false;
+            try
+            {
+                Kokkos::resilience::util::parse_strategies(spec, entries);
+            }
+            catch (std::runtime_error const&)
+            {
+                thrown = true;
+            }
+            success = success && thrown;
+        }
+
+        std::cout << "Execution Complete" << std::endl;
+    }
+
+    Kokkos::finalize();
+
+    return success ? 0 : 1;
+}
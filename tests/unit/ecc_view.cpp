@@ -0,0 +1,102 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <resilient_spaces/resilient_spaces.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cstdint>
+#include <iostream>
+
+using space = Kokkos::DefaultHostExecutionSpace;
+using view_type =
+    Kokkos::resilience::ecc::EccView<double, space::memory_space>;
+
+namespace detail = Kokkos::resilience::ecc::detail;
+
+// Flips bit b of the 72-bit codeword, bits from 64 on are check bits
+void flip(std::uint64_t& word, std::uint8_t& check, int b)
+{
+    if (b < 64)
+        word ^= std::uint64_t(1) << b;
+    else
+        check ^= std::uint8_t(1u << (b - 64));
+}
+
+int main(int argc, char* argv[])
+{
+    Kokkos::initialize(argc, argv);
+
+    bool success = true;
+    {
+        // Every single bit error is corrected, every double bit error is
+        // detected
+        std::uint64_t const words[] = {
+            0, ~std::uint64_t(0), 0x0123456789abcdefull};
+        for (std::uint64_t const original : words)
+        {
+            std::uint8_t const code = detail::encode(original);
+
+            for (int b = 0; b != 72; ++b)
+            {
+                std::uint64_t word = original;
+                std::uint8_t check = code;
+                flip(word, check, b);
+
+                success = success &&
+                    detail::decode(word, check) == detail::corrected &&
+                    word == original && check == code;
+
+                for (int c = b + 1; c != 72; ++c)
+                {
+                    std::uint64_t twice = original;
+                    std::uint8_t check_twice = code;
+                    flip(twice, check_twice, b);
+                    flip(twice, check_twice, c);
+
+                    success = success &&
+                        detail::decode(twice, check_twice) ==
+                            detail::uncorrectable;
+                }
+            }
+        }
+
+        std::size_t const n = 1000;
+        view_type view("ecc", n);
+
+        Kokkos::parallel_for(
+            "store", Kokkos::RangePolicy<space>(0, n),
+            KOKKOS_LAMBDA(int i) { view.store(i, 0.5 * i); });
+
+        // A single flipped bit is corrected on load and in memory
+        view.words()(10) ^= std::uint64_t(1) << 52;
+        view.checks()(20) ^= 4;
+
+        double sum = 0.;
+        Kokkos::parallel_reduce(
+            "load", Kokkos::RangePolicy<space>(0, n),
+            KOKKOS_LAMBDA(int i, double& s) { s += view.load(i); }, sum);
+
+        auto errors = view.errors();
+        success = success && sum == 0.25 * n * (n - 1) &&
+            errors.corrected == 2 && errors.uncorrectable == 0 &&
+            view.scrub() == 0 && view.errors().corrected == 2;
+
+        // Two flipped bits are detected
+        view.words()(30) ^= 3;
+        success = success && view.scrub() == 1;
+
+        errors = view.errors();
+        success = success && errors.corrected == 2 &&
+            errors.uncorrectable == 1;
+
+        std::cout << "Execution Complete" << std::endl;
+    }
+
+    Kokkos::finalize();
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,110 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <resilient_spaces/resilient_spaces.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <iostream>
+#include <stdexcept>
+
+using space = Kokkos::DefaultHostExecutionSpace;
+using view_type = Kokkos::View<int*, space>;
+
+// Counts the evaluations of each index, the first `faults` are wrong
+struct operation
+{
+    KOKKOS_FUNCTION int operator()(int i) const
+    {
+        int const attempt = Kokkos::atomic_fetch_add(&attempts(i), 1);
+        data(i) = 2 * i + shift();
+        return attempt < faults() ? -1 : data(i);
+    }
+
+    view_type data;
+    view_type attempts;
+    Kokkos::View<int, space> shift;
+    Kokkos::View<int, space> faults;
+};
+
+struct validator
+{
+    KOKKOS_FUNCTION bool operator()(int, int result) const
+    {
+        return result >= 0;
+    }
+};
+
+int main(int argc, char* argv[])
+{
+    Kokkos::initialize(argc, argv);
+
+    bool success = true;
+    {
+        using replay = Kokkos::resilience::ResilientReplay<space, validator>;
+        using replicate = Kokkos::resilience::ResilientReplicate<space>;
+
+        int const n = 1000;
+        space inst{};
+
+        view_type data("data", n);
+        view_type attempts("attempts", n);
+        Kokkos::View<int, space> shift("shift");
+        Kokkos::View<int, space> faults("faults");
+
+        operation const op{data, attempts, shift, faults};
+
+        Kokkos::resilience::LaunchPlan plan;
+        plan.parallel_for("replayed",
+            Kokkos::RangePolicy<replay>(replay(3, validator{}, inst), 0, n),
+            op);
+        plan.parallel_for(
+            Kokkos::RangePolicy<replicate>(replicate(inst), 0, n), op);
+        success = success && plan.size() == 2;
+
+        // New values of the captured Views are picked up by every
+        // submission, fault flags are reset in between
+        for (int step = 0; step != 3; ++step)
+        {
+            shift() = step;
+            faults() = step == 1 ? 1 : 0;
+            Kokkos::deep_copy(attempts, 0);
+
+            plan.submit();
+            Kokkos::fence();
+
+            for (int i = 0; i != n; ++i)
+            {
+                success = success && data(i) == 2 * i + step &&
+                    attempts(i) == (step == 1 ? 4 : 3);
+            }
+        }
+
+        // Out of replays
+        faults() = 3;
+        Kokkos::deep_copy(attempts, 0);
+        bool thrown = false;
+        try
+        {
+            plan.submit();
+        }
+        catch (std::runtime_error const&)
+        {
+            thrown = true;
+        }
+        success = success && thrown;
+
+        faults() = 0;
+        plan.submit();
+        Kokkos::fence();
+
+        std::cout << "Execution Complete" << std::endl;
+    }
+
+    Kokkos::finalize();
+
+    return success ? 0 : 1;
+}
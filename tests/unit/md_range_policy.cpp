@@ -14,6 +14,11 @@ struct validator
     {
         return true;
     }
+
+    bool operator()(int const& sum) const
+    {
+        return sum == 1000;
+    }
 };
 
 struct operation
@@ -28,6 +33,7 @@ int main(int argc, char* argv[])
 {
     Kokkos::initialize(argc, argv);
 
+    bool success = true;
     {
         validator validate{};
         operation op{};
@@ -71,6 +77,18 @@ int main(int argc, char* argv[])
                     Kokkos::Rank<2>>(replicate_validate_inst, {0, 0}, {10, 10}),
                 op);
             Kokkos::fence();
+
+            // Tiled reduction
+            int sum = 0;
+            Kokkos::parallel_reduce(
+                Kokkos::MDRangePolicy<
+                    Kokkos::resilience::ResilientReplay<
+                        Kokkos::DefaultHostExecutionSpace, validator>,
+                    Kokkos::Rank<3>>(
+                    replay_inst, {0, 0, 0}, {10, 10, 10}, {2, 5, 10}),
+                KOKKOS_LAMBDA(int, int, int, int& partial) { partial += 1; },
+                sum);
+            success = success && sum == 1000;
         }
 
         // Device only variant
@@ -118,5 +136,5 @@ int main(int argc, char* argv[])
 
     Kokkos::finalize();
 
-    return 0;
+    return success ? 0 : 1;
 }
@@ -0,0 +1,190 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <resilient_spaces/resilient_spaces.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <iostream>
+#include <type_traits>
+
+using space = Kokkos::DefaultExecutionSpace;
+using view_type = Kokkos::View<int*, space>;
+
+struct tag
+{
+};
+
+struct validator
+{
+    template <typename... Args>
+    KOKKOS_FUNCTION bool operator()(Args const&...) const
+    {
+        return true;
+    }
+};
+
+// Only accepts tagged calls
+struct tagged_validator
+{
+    KOKKOS_FUNCTION bool operator()(tag, int, int result) const
+    {
+        return result == 1;
+    }
+
+    KOKKOS_FUNCTION bool operator()(tag, int, int, int result) const
+    {
+        return result == 2;
+    }
+
+    KOKKOS_FUNCTION bool operator()(tag, int const& sum) const
+    {
+        return sum == 100;
+    }
+};
+
+struct tagged_operation
+{
+    KOKKOS_FUNCTION int operator()(tag, int i) const
+    {
+        data(i) = 1;
+        return data(i);
+    }
+
+    KOKKOS_FUNCTION int operator()(tag, int i, int j) const
+    {
+        data(i * 10 + j) = 2;
+        return data(i * 10 + j);
+    }
+
+    view_type data;
+};
+
+struct tagged_sum
+{
+    KOKKOS_FUNCTION void operator()(tag, int, int& sum) const
+    {
+        sum += 1;
+    }
+};
+
+struct operation
+{
+    template <typename I>
+    KOKKOS_FUNCTION int operator()(I i) const
+    {
+        data(i) = 3;
+        return data(i);
+    }
+
+    view_type data;
+};
+
+bool all_equal(view_type const& data, int value)
+{
+    auto host = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, data);
+
+    bool equal = true;
+    for (std::size_t i = 0; i != host.extent(0); ++i)
+        equal = equal && host(i) == value;
+    return equal;
+}
+
+int main(int argc, char* argv[])
+{
+    Kokkos::initialize(argc, argv);
+
+    bool success = true;
+    {
+        using replay = Kokkos::resilience::ResilientReplay<space, validator>;
+        using tagged_replay =
+            Kokkos::resilience::ResilientReplay<space, tagged_validator>;
+        using replicate = Kokkos::resilience::ResilientReplicate<space>;
+        using replicate_validate =
+            Kokkos::resilience::ResilientReplicateValidate<space, validator>;
+
+        namespace traits = Kokkos::resilience::traits;
+
+        // The resilient space is replaced in place, other traits are kept
+        static_assert(
+            std::is_same<traits::RangePolicyExtracter<Kokkos::IndexType<int>,
+                             replay, tag>::RangePolicy,
+                Kokkos::RangePolicy<Kokkos::IndexType<int>, space,
+                    tag>>::value,
+            "Unexpected base policy.");
+        static_assert(std::is_same<traits::RangePolicyExtracter<tag,
+                                       Kokkos::Schedule<Kokkos::Dynamic>,
+                                       replicate>::base_execution_space,
+                          space>::value,
+            "Unexpected base execution space.");
+
+        space inst{};
+        view_type data("data", 100);
+        view_type dummy("dummy", 100);
+
+        // Execution space after other traits
+        Kokkos::parallel_for(
+            Kokkos::RangePolicy<Kokkos::IndexType<int>, replay>(
+                replay(3, validator{}, inst), 0, 100),
+            operation{data});
+        Kokkos::fence();
+        success = success && all_equal(data, 3);
+
+        // Tagged functor and tagged validator
+        Kokkos::parallel_for(Kokkos::RangePolicy<tag, tagged_replay>(
+                                 tagged_replay(3, tagged_validator{}, inst),
+                                 0, 100),
+            tagged_operation{data});
+        Kokkos::fence();
+        success = success && all_equal(data, 1);
+
+        // Tagged functor, the validator does not take the tag
+        Kokkos::parallel_for(
+            Kokkos::RangePolicy<replicate_validate, tag,
+                Kokkos::IndexType<int>>(
+                replicate_validate(3, validator{}, inst), 0, 100),
+            tagged_operation{dummy});
+        Kokkos::fence();
+        success = success && all_equal(dummy, 1);
+
+        // Dynamic schedule with a chunk size
+        Kokkos::parallel_for(
+            Kokkos::RangePolicy<Kokkos::Schedule<Kokkos::Dynamic>, replicate,
+                Kokkos::IndexType<long>>(
+                replicate(inst), 0, 100, Kokkos::ChunkSize(7)),
+            operation{data});
+        Kokkos::fence();
+        success = success && all_equal(data, 3);
+
+        // Tagged MDRange with tiles
+        Kokkos::parallel_for(
+            Kokkos::MDRangePolicy<tag, Kokkos::Rank<2>, tagged_replay>(
+                tagged_replay(3, tagged_validator{}, inst), {0, 0}, {10, 10},
+                {2, 5}),
+            tagged_operation{data});
+        Kokkos::parallel_for(
+            Kokkos::MDRangePolicy<Kokkos::Rank<2>, tag, replicate>(
+                replicate(inst), {0, 0}, {10, 10}, {5, 2}),
+            tagged_operation{dummy});
+        Kokkos::fence();
+        success = success && all_equal(data, 2) && all_equal(dummy, 2);
+
+        // Tagged reduction with a tagged result validator
+        int sum = 0;
+        Kokkos::parallel_reduce(
+            Kokkos::RangePolicy<Kokkos::Schedule<Kokkos::Dynamic>, tag,
+                tagged_replay>(tagged_replay(3, tagged_validator{}, inst), 0,
+                100),
+            tagged_sum{}, Kokkos::Sum<int, Kokkos::HostSpace>(sum));
+        success = success && sum == 100;
+
+        std::cout << "Execution Complete" << std::endl;
+    }
+
+    Kokkos::finalize();
+
+    return success ? 0 : 1;
+}
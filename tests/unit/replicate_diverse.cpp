@@ -0,0 +1,139 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <resilient_spaces/resilient_spaces.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <iostream>
+#include <stdexcept>
+
+using space = Kokkos::DefaultHostExecutionSpace;
+using view_type = Kokkos::View<int*, space>;
+
+// Evaluations [first, first + faults) of each index write and return a
+// wrong result, replica r makes evaluation r.
+struct operation
+{
+    KOKKOS_FUNCTION int operator()(int i) const
+    {
+        int const attempt = Kokkos::atomic_fetch_add(&attempts(i), 1);
+        bool const faulty = attempt >= first && attempt < first + faults;
+        data(i) = faulty ? -attempt - 1 : 2 * i;
+        return data(i);
+    }
+
+    view_type data;
+    view_type attempts;
+    int first;
+    int faults;
+};
+
+// Replica r is wrong in lane r only, so that no two replicas agree as a
+// whole. A faulty rerun is wrong in lane 0.
+struct lane_operation
+{
+    KOKKOS_FUNCTION Kokkos::Array<int, 4> operator()(int i) const
+    {
+        int const attempt = Kokkos::atomic_fetch_add(&attempts(i), 1);
+
+        Kokkos::Array<int, 4> result{{i, 2 * i, 3 * i, 4 * i}};
+        if (attempt < 3)
+            result[attempt] = -i - 1;
+        else if (faulty_rerun)
+            result[0] = -i - 1;
+
+        data(i) = result[0] + result[1] + result[2] + result[3];
+        return result;
+    }
+
+    view_type data;
+    view_type attempts;
+    bool faulty_rerun;
+};
+
+int main(int argc, char* argv[])
+{
+    Kokkos::initialize(argc, argv);
+
+    bool success = true;
+    {
+        using diverse = Kokkos::resilience::ResilientReplicateDiverse<space>;
+        using range_policy = Kokkos::RangePolicy<diverse>;
+
+        int const n = 10000;
+        space inst{};
+
+        view_type data("data", n);
+        view_type attempts("attempts", n);
+
+        auto const check = [&](int runs) {
+            bool correct = true;
+            for (int i = 0; i != n; ++i)
+            {
+                correct = correct && attempts(i) == (i < 10 ? 0 : runs) &&
+                    data(i) == (i < 10 ? 0 : 2 * i);
+            }
+            Kokkos::deep_copy(attempts, 0);
+            return correct;
+        };
+
+        // A single faulty replica is outvoted
+        Kokkos::parallel_for(range_policy(diverse(inst), 10, n),
+            operation{data, attempts, 0, 1});
+        Kokkos::fence();
+        success = success && check(3);
+
+        // The writes of an outvoted last replica are replaced
+        Kokkos::parallel_for(range_policy(diverse(inst), 10, n),
+            operation{data, attempts, 2, 1});
+        Kokkos::fence();
+        success = success && check(4);
+
+        // The rerun replacing the writes of the last replica must match
+        // the per-lane majority of the three
+        Kokkos::parallel_for(range_policy(diverse(inst), 10, n),
+            lane_operation{data, attempts, false});
+        Kokkos::fence();
+        bool lanes = true;
+        for (int i = 10; i != n; ++i)
+            lanes = lanes && attempts(i) == 4 && data(i) == 10 * i;
+        Kokkos::deep_copy(attempts, 0);
+        success = success && lanes;
+
+        bool rejected = false;
+        try
+        {
+            Kokkos::parallel_for(range_policy(diverse(inst), 10, n),
+                lane_operation{data, attempts, true});
+        }
+        catch (std::runtime_error const&)
+        {
+            rejected = true;
+        }
+        Kokkos::deep_copy(attempts, 0);
+        success = success && rejected;
+
+        // No majority
+        bool thrown = false;
+        try
+        {
+            Kokkos::parallel_for(range_policy(diverse(inst), 0, n),
+                operation{data, attempts, 0, 2});
+        }
+        catch (std::runtime_error const&)
+        {
+            thrown = true;
+        }
+        success = success && thrown;
+
+        std::cout << "Execution Complete" << std::endl;
+    }
+
+    Kokkos::finalize();
+
+    return success ? 0 : 1;
+}
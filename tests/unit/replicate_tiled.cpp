@@ -0,0 +1,121 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <resilient_spaces/resilient_spaces.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <iostream>
+#include <stdexcept>
+
+using space = Kokkos::DefaultHostExecutionSpace;
+using view_type = Kokkos::View<int*, space>;
+using view_2d_type = Kokkos::View<int**, space>;
+
+// Returns a wrong result for the first `faults` evaluations of each index
+struct operation
+{
+    KOKKOS_FUNCTION int operator()(int i) const
+    {
+        int const attempt = Kokkos::atomic_fetch_add(&attempts(i), 1);
+        data(i) = 2 * i;
+        return attempt < faults ? -attempt - 1 : data(i);
+    }
+
+    view_type data;
+    view_type attempts;
+    int faults;
+};
+
+struct operation_2d
+{
+    KOKKOS_FUNCTION int operator()(int i, int j) const
+    {
+        int const attempt = Kokkos::atomic_fetch_add(&attempts(i, j), 1);
+        data(i, j) = i * j;
+        return attempt < faults ? -attempt - 1 : data(i, j);
+    }
+
+    view_2d_type data;
+    view_2d_type attempts;
+    int faults;
+};
+
+int main(int argc, char* argv[])
+{
+    Kokkos::initialize(argc, argv);
+
+    bool success = true;
+    {
+        using tiled = Kokkos::resilience::ResilientReplicateTiled<space>;
+        using range_policy = Kokkos::RangePolicy<tiled>;
+        using mdrange_policy = Kokkos::MDRangePolicy<tiled, Kokkos::Rank<2>>;
+
+        int const n = 1000;
+        space inst{};
+
+        view_type data("data", n);
+        view_type attempts("attempts", n);
+
+        // Agreeing passes, the last tile is partial
+        Kokkos::parallel_for(range_policy(tiled(64, inst), 10, n),
+            operation{data, attempts, 0});
+        Kokkos::fence();
+
+        for (int i = 0; i != n; ++i)
+        {
+            success = success && attempts(i) == (i < 10 ? 0 : 2) &&
+                data(i) == (i < 10 ? 0 : 2 * i);
+        }
+
+        // A faulty first pass is outvoted by the third
+        Kokkos::deep_copy(attempts, 0);
+        Kokkos::parallel_for(range_policy(tiled(64, inst), 0, n),
+            operation{data, attempts, 1});
+        Kokkos::fence();
+
+        for (int i = 0; i != n; ++i)
+            success = success && attempts(i) == 3;
+
+        // No two passes agree
+        Kokkos::deep_copy(attempts, 0);
+        bool thrown = false;
+        try
+        {
+            Kokkos::parallel_for(range_policy(tiled(64, inst), 0, n),
+                operation{data, attempts, 2});
+        }
+        catch (std::runtime_error const&)
+        {
+            thrown = true;
+        }
+        success = success && thrown;
+
+        // Tiles of the policy, partial in both dimensions
+        view_2d_type data_2d("data_2d", 50, 30);
+        view_2d_type attempts_2d("attempts_2d", 50, 30);
+
+        Kokkos::parallel_for(
+            mdrange_policy(tiled(0, inst), {0, 0}, {50, 30}, {8, 7}),
+            operation_2d{data_2d, attempts_2d, 1});
+        Kokkos::fence();
+
+        for (int i = 0; i != 50; ++i)
+        {
+            for (int j = 0; j != 30; ++j)
+            {
+                success = success && attempts_2d(i, j) == 3 &&
+                    data_2d(i, j) == i * j;
+            }
+        }
+
+        std::cout << "Execution Complete" << std::endl;
+    }
+
+    Kokkos::finalize();
+
+    return success ? 0 : 1;
+}
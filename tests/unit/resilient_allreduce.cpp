@@ -0,0 +1,106 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <resilient_spaces/mpi/allreduce.hpp>
+
+#include <mpi.h>
+
+#include <cstddef>
+#include <iostream>
+
+int main(int argc, char* argv[])
+{
+    MPI_Init(&argc, &argv);
+
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    namespace krs_mpi = Kokkos::resilience::mpi;
+    using krs_mpi::reduce_op;
+
+    bool success = true;
+    {
+        krs_mpi::ResilientAllreduce reduction;
+
+        // Corrupt the first result received by the last rank only
+        bool injected = false;
+        reduction.set_fault_injector([&](double* payload, std::size_t) {
+            if (!injected && rank == size - 1)
+            {
+                payload[0] += 1.;
+                injected = true;
+            }
+        });
+
+        std::size_t const max = reduction.add(0.1 * rank, reduce_op::max);
+        std::size_t const min = reduction.add(0.1 * rank, reduce_op::min);
+        std::size_t const sum = reduction.add(rank + 1., reduce_op::sum);
+        reduction.execute();
+
+        success = success && reduction.result(max) == 0.1 * (size - 1);
+        success = success && reduction.result(min) == 0.;
+        success = success && reduction.result(sum) == size * (size + 1) / 2.;
+
+        // Every rank retried the batch exactly once
+        success = success && reduction.retries() == 1;
+
+        // Reuse without faults
+        reduction.clear();
+        std::size_t const again = reduction.add(1., reduce_op::sum);
+        reduction.execute();
+
+        success = success && reduction.result(again) == double(size);
+        success = success && reduction.retries() == 1;
+
+        // A corrupted local contribution, evaluated independently for the
+        // shadow, is caught and evaluated again
+        reduction.clear();
+        int evaluations = 0;
+        std::size_t const local = reduction.add(
+            [&] {
+                ++evaluations;
+                return evaluations == 1 && rank == 0 ? 1000. : double(rank);
+            },
+            reduce_op::max);
+        reduction.execute();
+
+        success = success && reduction.result(local) == double(size - 1);
+        success = success && reduction.retries() == 2;
+        success = success && evaluations == 4;
+
+        // A contribution computes its shadow in the same evaluation
+        reduction.clear();
+        evaluations = 0;
+        std::size_t const fused = reduction.add(
+            [&] {
+                ++evaluations;
+                double const shadow = -double(rank);
+                return krs_mpi::contribution{
+                    evaluations == 1 && rank == 0 ? 1000. : -shadow, shadow};
+            },
+            reduce_op::max);
+        reduction.execute();
+
+        success = success && reduction.result(fused) == double(size - 1);
+        success = success && reduction.retries() == 3;
+        success = success && evaluations == 2;
+
+        success = success &&
+            krs_mpi::allreduce(double(rank), reduce_op::max) ==
+                double(size - 1);
+    }
+
+    int failed = !success;
+    MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_LOR, MPI_COMM_WORLD);
+
+    if (rank == 0)
+        std::cout << "Execution Complete" << std::endl;
+
+    MPI_Finalize();
+
+    return failed ? 1 : 0;
+}
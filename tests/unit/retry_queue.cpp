@@ -0,0 +1,159 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <resilient_spaces/resilient_spaces.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <iostream>
+#include <stdexcept>
+
+using space = Kokkos::DefaultExecutionSpace;
+using view_type = Kokkos::View<int*, space>;
+
+// Every `stride`th index fails its first `failures` attempts
+struct validator
+{
+    KOKKOS_FUNCTION bool operator()(int i, int result) const
+    {
+        return i % stride != 0 || result > failures;
+    }
+
+    int failures;
+    int stride;
+};
+
+// Records the position of the last attempt of every index among all
+// attempts, retries from a round come after the whole primary pass.
+struct operation
+{
+    KOKKOS_FUNCTION int operator()(int i) const
+    {
+        int const attempt = Kokkos::atomic_fetch_add(&attempts(i), 1) + 1;
+        order(i) = Kokkos::atomic_fetch_add(&sequence(), 1);
+        data(i) = i;
+        return attempt;
+    }
+
+    view_type data;
+    view_type attempts;
+    view_type order;
+    Kokkos::View<int, space> sequence;
+};
+
+int main(int argc, char* argv[])
+{
+    Kokkos::initialize(argc, argv);
+
+    bool success = true;
+    {
+        using replay = Kokkos::resilience::ResilientReplay<space, validator>;
+        using range_policy = Kokkos::RangePolicy<replay>;
+
+        int const n = 100000;
+        space inst{};
+
+        view_type data("data", n);
+        view_type attempts("attempts", n);
+        view_type order("order", n);
+        Kokkos::View<int, space> sequence("sequence");
+        operation const op{data, attempts, order, sequence};
+
+        using queue_type = Kokkos::resilience::util::RetryQueue<space, int>;
+
+        // Each index runs exactly as often as it needs to, all retries
+        // come from the retry rounds unless retried inline
+        auto const retried = [&](int stride, int failures, int m) {
+            // Serial spaces and small ranges retry failed indices inline
+            bool const queued = queue_type::replay_capacity(m) != 0;
+            Kokkos::fence();
+            auto host_data =
+                Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, data);
+            auto host_attempts = Kokkos::create_mirror_view_and_copy(
+                Kokkos::HostSpace{}, attempts);
+            auto host_order = Kokkos::create_mirror_view_and_copy(
+                Kokkos::HostSpace{}, order);
+
+            bool correct = true;
+            for (int i = 0; i != n; ++i)
+            {
+                bool const failing = i < m && i % stride == 0;
+                int const expected = i >= m ? 0 : failing ? failures + 1 : 1;
+                correct = correct && host_data(i) == i &&
+                    host_attempts(i) == expected &&
+                    (!failing || !queued || host_order(i) >= m);
+            }
+
+            Kokkos::deep_copy(attempts, 0);
+            Kokkos::deep_copy(sequence, 0);
+            return correct;
+        };
+
+        // Failures fit in the queue
+        Kokkos::parallel_for(
+            range_policy(replay(4, validator{2, 1000}, inst), 0, n), op);
+        success = success && retried(1000, 2, n);
+
+        // A burst beyond the queue capacity goes to the overflow bitmap
+        Kokkos::parallel_for(
+            range_policy(replay(4, validator{3, 7}, inst), 0, n), op);
+        success = success && retried(7, 3, n);
+
+        // Every index fails once
+        Kokkos::parallel_for(
+            range_policy(replay(2, validator{1, 1}, inst), 0, n), op);
+        success = success && retried(1, 1, n);
+
+        // Small ranges are retried inline
+        Kokkos::parallel_for(
+            range_policy(replay(4, validator{3, 7}, inst), 0, 1000), op);
+        success = success && retried(7, 3, 1000);
+
+        // Attempts are exhausted
+        bool thrown = false;
+        try
+        {
+            Kokkos::parallel_for(
+                range_policy(replay(3, validator{3, 7}, inst), 0, n), op);
+        }
+        catch (std::runtime_error const&)
+        {
+            thrown = true;
+        }
+        success = success && thrown;
+
+        // Pushes beyond the capacity are rejected
+        queue_type queue(16);
+        Kokkos::View<int, space> rejected("rejected");
+        Kokkos::parallel_for(
+            "push", Kokkos::RangePolicy<space>(inst, 0, 20),
+            KOKKOS_LAMBDA(int i) {
+                if (!queue.push(i))
+                    Kokkos::atomic_fetch_add(&rejected(), 1);
+            });
+
+        int hrejected = 0;
+        Kokkos::deep_copy(hrejected, rejected);
+        success = success && queue.size() == 16 && hrejected == 4 &&
+            queue_type(0).size() == 0;
+
+        // Queues of a range keep them in the overflow bitmap instead
+        queue_type ranged(16, 100, 200);
+        Kokkos::parallel_for(
+            "push_range", Kokkos::RangePolicy<space>(inst, 100, 120),
+            KOKKOS_LAMBDA(int i) { ranged.push(i); });
+
+        std::size_t const pushed = ranged.count();
+        success = success && pushed == 20 && ranged.queued(pushed) == 16 &&
+            ranged.slots(pushed) == 18;
+
+        std::cout << "Execution Complete" << std::endl;
+    }
+
+    Kokkos::finalize();
+
+    return success ? 0 : 1;
+}
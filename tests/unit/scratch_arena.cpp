@@ -0,0 +1,110 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <resilient_spaces/resilient_spaces.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <iostream>
+
+using space = Kokkos::DefaultHostExecutionSpace;
+using memory_space = space::memory_space;
+
+struct operation
+{
+    KOKKOS_FUNCTION int operator()(int i) const
+    {
+        return 2 * i;
+    }
+};
+
+struct validator
+{
+    KOKKOS_FUNCTION bool operator()(int i, int result) const
+    {
+        return result == 2 * i;
+    }
+
+    bool operator()(long sum) const
+    {
+        return sum == 10000 * 9999L;
+    }
+};
+
+int main(int argc, char* argv[])
+{
+    Kokkos::initialize(argc, argv);
+
+    bool success = true;
+    {
+        using arena_type = Kokkos::resilience::util::ScratchArena<memory_space>;
+        using buffer_type =
+            Kokkos::resilience::util::ScratchView<double, memory_space>;
+
+        arena_type& arena = arena_type::instance();
+        auto const before = arena.statistics();
+
+        // Sizes of the same class share blocks
+        {
+            buffer_type a(100);
+            buffer_type copy = a;
+            copy(99) = 1.;
+            success = success && a(99) == 1.;
+        }
+        {
+            buffer_type b(120);
+            buffer_type c(10);
+        }
+
+        auto const after = arena.statistics();
+        success = success && after.allocations == before.allocations + 2 &&
+            after.reuses == before.reuses + 1 &&
+            after.in_use == before.in_use &&
+            after.high_water_mark >= before.in_use + 1024 + 128;
+
+        // Ownership moves with the buffer
+        buffer_type moved;
+        {
+            buffer_type owner(100);
+            moved = std::move(owner);
+        }
+        success = success && arena.statistics().in_use == after.in_use + 1024;
+
+        // Steady-state launches are served from the arena
+        using diverse = Kokkos::resilience::ResilientReplicateDiverse<space>;
+        auto const launch = [] {
+            Kokkos::parallel_for(
+                Kokkos::RangePolicy<diverse>(diverse(), 0, 10000),
+                operation{});
+        };
+
+        // Replayed reductions keep their backup in the arena
+        using replay = Kokkos::resilience::ResilientReplay<space, validator>;
+        auto const reduce = [] {
+            long sum = 0;
+            Kokkos::parallel_reduce(
+                Kokkos::RangePolicy<replay>(replay(3, validator{}), 0, 10000),
+                KOKKOS_LAMBDA(int i, long& partial) { partial += 2 * i; },
+                sum);
+            return sum;
+        };
+
+        launch();
+        success = success && reduce() == 10000 * 9999L;
+        auto const warm = arena.statistics();
+        launch();
+        launch();
+        success = success && reduce() == 10000 * 9999L;
+        success = success &&
+            arena.statistics().allocations == warm.allocations;
+
+        std::cout << "Execution Complete" << std::endl;
+    }
+
+    Kokkos::finalize();
+
+    return success ? 0 : 1;
+}
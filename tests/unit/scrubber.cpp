@@ -0,0 +1,142 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <resilient_spaces/resilient_spaces.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using view_type = Kokkos::View<double*, Kokkos::HostSpace>;
+
+int main(int argc, char* argv[])
+{
+    Kokkos::initialize(argc, argv);
+
+    bool success = true;
+    {
+        std::size_t const n = 5000;
+        std::size_t const block_values = 1024;
+        std::string const path = "krs_scrubber_test.bin";
+
+        view_type field("field", n);
+        view_type checkpointed("checkpointed", n);
+        for (std::size_t i = 0; i != n; ++i)
+        {
+            field(i) = 0.5 * i;
+            checkpointed(i) = 0.25 * i;
+        }
+
+        Kokkos::resilience::checkpoint::write(
+            path, checkpointed, block_values);
+
+        Kokkos::resilience::Scrubber scrubber(0, block_values);
+        scrubber.add(field);
+        scrubber.add(checkpointed, path);
+
+        std::size_t reported = 0;
+        bool restored = false;
+        scrubber.on_corruption(
+            [&](Kokkos::resilience::ScrubEvent const& event) {
+                reported = event.block;
+                restored = event.restored;
+            });
+
+        success = success && scrubber.scrub() == 0;
+
+        // Silent corruption is detected in its block
+        field(2500) = -1.;
+        success = success && scrubber.scrub() == 1 && reported == 2 &&
+            !restored;
+
+        // Rewritten values are accepted once touched
+        scrubber.pause();
+        field(2500) = 7.;
+        scrubber.touch(field, 2500, 2501);
+        scrubber.resume();
+        success = success && scrubber.scrub() == 0;
+
+        // Corrupted blocks are restored from the checkpoint
+        checkpointed(4999) = -1.;
+        success = success && scrubber.scrub() == 1 && reported == 4 &&
+            restored && checkpointed(4999) == 0.25 * 4999;
+        success = success && scrubber.scrub() == 0;
+
+        // Stale checkpointed blocks are not copied over live data
+        scrubber.pause();
+        checkpointed(0) = 3.;
+        scrubber.touch(checkpointed, 0, 1);
+        scrubber.resume();
+        checkpointed(1) = -1.;
+        success = success && scrubber.scrub() == 1 && reported == 0 &&
+            !restored && checkpointed(0) == 3. && checkpointed(1) == -1.;
+        checkpointed(1) = 0.25;
+
+        auto const statistics = scrubber.statistics();
+        success = success && statistics.corrupted_blocks == 3 &&
+            statistics.restored_blocks == 1;
+
+        // Background verification
+        {
+            Kokkos::resilience::Scrubber background(1u << 30, block_values);
+            background.add(field);
+
+            // Untouched writes are corruption
+            background.pause();
+            field(10) = -1.;
+            background.resume();
+
+            for (int wait = 0; wait != 1000 &&
+                 background.statistics().corrupted_blocks == 0;
+                 ++wait)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            success = success && background.statistics().corrupted_blocks != 0;
+        }
+
+        // Unreadable checkpoints are reported by the scrubbing thread
+        {
+            Kokkos::resilience::Scrubber background(1u << 30, block_values);
+            background.add(checkpointed, "krs_scrubber_missing.bin");
+
+            std::mutex mutex;
+            std::string error;
+            background.on_corruption(
+                [&](Kokkos::resilience::ScrubEvent const& event) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    error = event.error;
+                });
+
+            background.pause();
+            checkpointed(10) = -1.;
+            background.resume();
+
+            bool reported_error = false;
+            for (int wait = 0; wait != 1000 && !reported_error; ++wait)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+                std::lock_guard<std::mutex> lock(mutex);
+                reported_error = !error.empty();
+            }
+            success = success && reported_error && checkpointed(10) == -1.;
+        }
+
+        std::remove(path.c_str());
+
+        std::cout << "Execution Complete" << std::endl;
+    }
+
+    Kokkos::finalize();
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,236 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <resilient_spaces/resilient_spaces.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+
+using space = Kokkos::DefaultHostExecutionSpace;
+using view_type = Kokkos::View<double*, space>;
+using view_2d_type = Kokkos::View<double**, space>;
+using count_type = Kokkos::View<int*, space>;
+
+// Smoothing stencil in precision Real, only the double instantiation
+// writes. The first `faults` double evaluations of each index are off by
+// their attempt number, shadows are off if `shadow_fault` is set.
+template <typename Real>
+struct smooth
+{
+    template <typename Other>
+    using rebind = smooth<Other>;
+
+    smooth(view_type in_, view_type out_, count_type attempts_, int faults_,
+        bool shadow_fault_)
+      : in(in_)
+      , out(out_)
+      , attempts(attempts_)
+      , faults(faults_)
+      , shadow_fault(shadow_fault_)
+    {
+    }
+
+    template <typename Other>
+    explicit smooth(smooth<Other> const& other)
+      : smooth(other.in, other.out, other.attempts, other.faults,
+            other.shadow_fault)
+    {
+    }
+
+    KOKKOS_FUNCTION Real operator()(int i) const
+    {
+        Real const result = Real(0.25) *
+            (Real(in(i - 1)) + Real(2) * Real(in(i)) + Real(in(i + 1)));
+
+        if constexpr (std::is_same<Real, double>::value)
+        {
+            int const attempt = attempts(i)++;
+            out(i) = attempt < faults ? result + attempt + 1 : result;
+            return out(i);
+        }
+
+        return shadow_fault ? result + 1 : result;
+    }
+
+    view_type in;
+    view_type out;
+    count_type attempts;
+    int faults;
+    bool shadow_fault;
+};
+
+// Cancellation leaves a result near zero, the shadow is off by far more
+// than its roundoff relative to the result
+template <typename Real>
+struct cancel
+{
+    template <typename Other>
+    using rebind = cancel<Other>;
+
+    cancel() = default;
+
+    template <typename Other>
+    explicit cancel(cancel<Other> const& other)
+      : attempts(other.attempts)
+    {
+    }
+
+    KOKKOS_FUNCTION Real operator()(int i) const
+    {
+        if constexpr (std::is_same<Real, double>::value)
+            ++attempts(i);
+        return Real(0.1) * Real(3) - Real(0.3);
+    }
+
+    count_type attempts;
+};
+
+template <typename Real>
+struct product
+{
+    template <typename Other>
+    using rebind = product<Other>;
+
+    product() = default;
+
+    template <typename Other>
+    explicit product(product<Other> const& other)
+      : out(other.out)
+    {
+    }
+
+    KOKKOS_FUNCTION Real operator()(int i, int j) const
+    {
+        Real const result = Real(0.1) * Real(i) * Real(j);
+        if constexpr (std::is_same<Real, double>::value)
+            out(i, j) = result;
+        return result;
+    }
+
+    view_2d_type out;
+};
+
+int main(int argc, char* argv[])
+{
+    Kokkos::initialize(argc, argv);
+
+    bool success = true;
+    {
+        using shadow = Kokkos::resilience::ResilientShadowReplicate<space>;
+        using range_policy = Kokkos::RangePolicy<shadow>;
+        using mdrange_policy = Kokkos::MDRangePolicy<shadow, Kokkos::Rank<2>>;
+
+        int const n = 100000;
+        space inst{};
+
+        view_type in("in", n + 1);
+        view_type out("out", n + 1);
+        count_type attempts("attempts", n + 1);
+
+        for (int i = 0; i != n + 1; ++i)
+            in(i) = 1. + 1e-7 * i * i;
+
+        auto const expected = [&](int i) {
+            return 0.25 * (in(i - 1) + 2. * in(i) + in(i + 1));
+        };
+
+        auto const check = [&](int runs) {
+            bool correct = true;
+            for (int i = 1; i != n; ++i)
+            {
+                correct = correct && attempts(i) == runs &&
+                    out(i) == expected(i);
+            }
+            Kokkos::deep_copy(attempts, 0);
+            return correct;
+        };
+
+        // The float shadow agrees within the default bound
+        Kokkos::parallel_for(range_policy(shadow(), 1, n),
+            smooth<double>(in, out, attempts, 0, false));
+        Kokkos::fence();
+        success = success && check(1);
+
+        // A faulty first evaluation is caught by the shadow
+        Kokkos::parallel_for(range_policy(shadow(), 1, n),
+            smooth<double>(in, out, attempts, 1, false));
+        Kokkos::fence();
+        success = success && check(2);
+
+        // Only the flagged points run again, here those that were not
+        // evaluated before
+        for (int i = 1; i != n; ++i)
+            attempts(i) = i % 100 == 0 ? 0 : 1;
+        Kokkos::parallel_for(range_policy(shadow(), 1, n),
+            smooth<double>(in, out, attempts, 1, false));
+        Kokkos::fence();
+        success = success && check(2);
+
+        // A faulty shadow is outvoted by the functor agreeing with itself
+        Kokkos::parallel_for(range_policy(shadow(), 1, n),
+            smooth<double>(in, out, attempts, 0, true));
+        Kokkos::fence();
+        success = success && check(3);
+
+        // All evaluations faulty
+        bool caught = false;
+        try
+        {
+            Kokkos::parallel_for(range_policy(shadow(), 1, n),
+                smooth<double>(in, out, attempts, 3, false));
+        }
+        catch (std::runtime_error const&)
+        {
+            caught = true;
+        }
+        success = success && caught;
+
+        // A bound too tight for float flags most indices, more than the
+        // retry queue holds, the functor still agrees with itself
+        Kokkos::deep_copy(attempts, 0);
+        Kokkos::parallel_for(range_policy(shadow(0., 0., inst), 1, n),
+            smooth<double>(in, out, attempts, 0, false));
+        Kokkos::fence();
+        for (int i = 1; i != n; ++i)
+            success = success && attempts(i) >= 1 && attempts(i) <= 3;
+
+        // Results near zero need the absolute term of the default bound
+        cancel<double> near_zero;
+        near_zero.attempts = attempts;
+        Kokkos::deep_copy(attempts, 0);
+        Kokkos::parallel_for(range_policy(shadow(), 1, n), near_zero);
+        Kokkos::fence();
+        success = success && check(1);
+
+        Kokkos::parallel_for(
+            range_policy(shadow(shadow::relative_bound(), 0., inst), 1, n),
+            near_zero);
+        Kokkos::fence();
+        for (int i = 1; i != n; ++i)
+            success = success && attempts(i) == 3;
+
+        product<double> op;
+        op.out = view_2d_type("out", 10, 20);
+        Kokkos::parallel_for(
+            mdrange_policy(shadow(), {0, 0}, {10, 20}), op);
+        Kokkos::fence();
+
+        for (int i = 0; i != 10; ++i)
+        {
+            for (int j = 0; j != 20; ++j)
+                success = success && op.out(i, j) == 0.1 * i * j;
+        }
+
+        std::cout << "Execution Complete" << std::endl;
+    }
+
+    Kokkos::finalize();
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <resilient_spaces/resilient_spaces.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cstddef>
+#include <iostream>
+
+using space = Kokkos::DefaultExecutionSpace;
+using view_type = Kokkos::View<int*, space>;
+
+int const n = 1000;
+
+// Checks the sum captured by the step, rejects the first validation of
+// step `faulty`.
+struct validator
+{
+    bool operator()(std::size_t step) const
+    {
+        int sum = 0;
+        Kokkos::deep_copy(sum, Kokkos::subview(sums, step));
+
+        calls(step) += 1;
+        if (step == faulty && calls(step) == 1)
+            return false;
+
+        return sum == int(step + 1) * n;
+    }
+
+    view_type sums;
+    Kokkos::View<int*, Kokkos::HostSpace> calls;
+    std::size_t faulty;
+};
+
+int main(int argc, char* argv[])
+{
+    Kokkos::initialize(argc, argv);
+
+    bool success = true;
+    {
+        using replay_space =
+            Kokkos::resilience::ResilientReplay<space, validator>;
+        using range_policy = Kokkos::RangePolicy<space>;
+
+        std::size_t const steps = 10;
+        space inst{};
+
+        view_type data("data", n);
+        view_type sums("sums", steps);
+        Kokkos::View<int*, Kokkos::HostSpace> calls("calls", steps);
+
+        // Steps 4 to 7 form the second window, step 6 is rejected once and
+        // the window is replayed from the state after step 3
+        Kokkos::resilience::ResilientSpeculation<space, validator> speculation(
+            replay_space(3, validator{sums, calls, 6}, inst), 4);
+        speculation.protect(data);
+
+        for (std::size_t s = 0; s != steps; ++s)
+        {
+            speculation.step([=](std::size_t step) {
+                Kokkos::parallel_for("increment", range_policy(inst, 0, n),
+                    KOKKOS_LAMBDA(int i) { data(i) += 1; });
+                Kokkos::parallel_reduce("sum", range_policy(inst, 0, n),
+                    KOKKOS_LAMBDA(int i, int& sum) { sum += data(i); },
+                    Kokkos::subview(sums, step));
+            });
+        }
+        speculation.synchronize();
+
+        auto hdata =
+            Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, data);
+        for (int i = 0; i != n; ++i)
+            success = success && hdata(i) == int(steps);
+
+        for (std::size_t s = 0; s != steps; ++s)
+            success = success && calls(s) == (s >= 4 && s < 8 ? 2 : 1);
+
+        success = success && speculation.rollbacks() == 1 &&
+            speculation.steps() == steps;
+
+        // A rejected step in the last, partial window is replayed by the
+        // destructor
+        Kokkos::deep_copy(data, 0);
+        Kokkos::deep_copy(calls, 0);
+        {
+            Kokkos::resilience::ResilientSpeculation<space, validator> last(
+                replay_space(3, validator{sums, calls, 1}, inst), 4);
+            last.protect(data);
+
+            for (std::size_t s = 0; s != 2; ++s)
+            {
+                last.step([=](std::size_t step) {
+                    Kokkos::parallel_for("increment", range_policy(inst, 0, n),
+                        KOKKOS_LAMBDA(int i) { data(i) += 1; });
+                    Kokkos::parallel_reduce("sum", range_policy(inst, 0, n),
+                        KOKKOS_LAMBDA(int i, int& sum) { sum += data(i); },
+                        Kokkos::subview(sums, step));
+                });
+            }
+        }
+
+        Kokkos::deep_copy(hdata, data);
+        for (int i = 0; i != n; ++i)
+            success = success && hdata(i) == 2;
+        success = success && calls(0) == 2 && calls(1) == 2;
+
+        std::cout << "Execution Complete" << std::endl;
+    }
+
+    Kokkos::finalize();
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <resilient_spaces/resilient_spaces.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <iostream>
+#include <stdexcept>
+
+using space = Kokkos::DefaultExecutionSpace;
+using view_type = Kokkos::View<int*, space>;
+
+// Rejects the first `failures` groups and checks the group's result.
+struct validator
+{
+    bool operator()() const
+    {
+        auto hsum =
+            Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, sum);
+        auto hcalls = Kokkos::create_mirror_view(calls);
+
+        hcalls() += 1;
+        return hcalls() > failures && hsum() == expected;
+    }
+
+    Kokkos::View<int, space> sum;
+    Kokkos::View<int, Kokkos::HostSpace> calls;
+    int failures;
+    int expected;
+};
+
+int main(int argc, char* argv[])
+{
+    Kokkos::initialize(argc, argv);
+
+    bool success = true;
+    {
+        using replay_space =
+            Kokkos::resilience::ResilientReplay<space, validator>;
+        using range_policy = Kokkos::RangePolicy<space>;
+
+        int const n = 1000;
+        view_type data("data", n);
+        view_type twice("twice", n);
+        Kokkos::View<int, space> sum("sum");
+        Kokkos::View<int, Kokkos::HostSpace> calls("calls");
+
+        space inst{};
+
+        // Two dependent in-place kernels validated once, the first group is
+        // rejected and must be replayed from the saved state.
+        Kokkos::resilience::ResilientTransaction<space, validator> tx(
+            replay_space(3, validator{sum, calls, 1, 3 * n}, inst));
+
+        tx.protect(data);
+        tx.parallel_for("increment", range_policy(inst, 0, n),
+            KOKKOS_LAMBDA(int i) { data(i) += 1; });
+        tx.parallel_for("scale", range_policy(inst, 0, n),
+            KOKKOS_LAMBDA(int i) { twice(i) = 2 * data(i); });
+        tx.parallel_reduce("sum", range_policy(inst, 0, n),
+            KOKKOS_LAMBDA(int i, int& s) { s += data(i) + twice(i); }, sum);
+        tx.execute();
+
+        auto hdata =
+            Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, data);
+        for (int i = 0; i != n; ++i)
+            success = success && hdata(i) == 1;
+
+        success = success && calls() == 2 && tx.replayed() == 1;
+
+        // A group that never validates runs out of replays
+        calls() = 0;
+        Kokkos::resilience::ResilientTransaction<space, validator> failing(
+            replay_space(2, validator{sum, calls, 5, 3 * n}, inst));
+
+        failing.protect(data);
+        failing.parallel_reduce("sum", range_policy(inst, 0, n),
+            KOKKOS_LAMBDA(int i, int& s) { s += 3 * data(i); }, sum);
+
+        bool thrown = false;
+        try
+        {
+            failing.execute();
+        }
+        catch (std::runtime_error const&)
+        {
+            thrown = true;
+        }
+        success = success && thrown && calls() == 2;
+
+        std::cout << "Execution Complete" << std::endl;
+    }
+
+    Kokkos::finalize();
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,144 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <resilient_spaces/resilient_spaces.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+using space = Kokkos::DefaultExecutionSpace;
+using view_type = Kokkos::View<double*, space>;
+
+namespace validators = Kokkos::resilience::validators;
+
+struct tag
+{
+};
+
+// Doubles the previous value, index `bad` produces `value` instead
+struct operation
+{
+    KOKKOS_FUNCTION double operator()(int i) const
+    {
+        data(i) = i == bad ? value : 2 * previous(i);
+        return data(i);
+    }
+
+    KOKKOS_FUNCTION double operator()(tag, int i) const
+    {
+        return (*this)(i);
+    }
+
+    view_type data;
+    view_type previous;
+    int bad;
+    double value;
+};
+
+template <typename Policy>
+bool accepted(Policy const& policy, operation const& op)
+{
+    try
+    {
+        Kokkos::parallel_for(policy, op);
+        Kokkos::fence();
+    }
+    catch (std::runtime_error const&)
+    {
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    Kokkos::initialize(argc, argv);
+
+    bool success = true;
+    {
+        using fused_type =
+            validators::all_of<validators::finite, validators::bounds<double>,
+                validators::monotonic<view_type>,
+                validators::relative_residual<view_type>>;
+        using replicate =
+            Kokkos::resilience::ResilientReplicateValidate<space, fused_type>;
+
+        int const n = 1000;
+        space inst{};
+
+        view_type data("data", n);
+        view_type previous("previous", n);
+        view_type reference("reference", n);
+
+        Kokkos::parallel_for(
+            "init", Kokkos::RangePolicy<space>(inst, 0, n),
+            KOKKOS_LAMBDA(int i) {
+                previous(i) = i + 1;
+                reference(i) = 2 * (i + 1);
+            });
+
+        fused_type const fused = validators::all(validators::finite{},
+            validators::bounds<double>{0., 2. * n},
+            validators::monotonic<view_type>{previous},
+            validators::relative_residual<view_type>{reference, 1e-12});
+
+        auto policy = [&](fused_type const& v) {
+            return Kokkos::RangePolicy<tag, replicate>(replicate(2, v, inst),
+                0, n);
+        };
+
+        double const nan = std::numeric_limits<double>::quiet_NaN();
+        double const inf = std::numeric_limits<double>::infinity();
+
+        success = success &&
+            accepted(policy(fused), operation{data, previous, -1, 0.});
+        success = success &&
+            !accepted(policy(fused), operation{data, previous, 3, nan});
+        success = success &&
+            !accepted(policy(fused), operation{data, previous, 3, inf});
+        success = success &&
+            !accepted(policy(fused), operation{data, previous, 3, -1.});
+        success = success &&
+            !accepted(policy(fused), operation{data, previous, 3, 8.001});
+
+        // Not monotonic (2 < previous(3)), within bounds
+        fused_type loose = fused;
+        loose.rest.rest.rest.first.tolerance = 1.;
+        success = success &&
+            !accepted(policy(loose), operation{data, previous, 3, 2.});
+
+        // Block validators
+        Kokkos::parallel_for(
+            "fill", Kokkos::RangePolicy<space>(inst, 0, n),
+            KOKKOS_LAMBDA(int i) { data(i) = reference(i); });
+        Kokkos::fence();
+
+        auto block = validators::make_block(data, fused, inst);
+        success = success && block() && block.failures() == 0;
+
+        validators::conservation<view_type> mass(
+            data, double(n) * (n + 1), 1e-10, inst);
+        success = success && mass();
+
+        auto host =
+            Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, data);
+        host(5) = nan;
+        host(7) = 1.;
+        Kokkos::deep_copy(data, host);
+
+        success = success && block.failures() == 2 && !mass();
+
+        std::cout << "Execution Complete" << std::endl;
+    }
+
+    Kokkos::finalize();
+
+    return success ? 0 : 1;
+}
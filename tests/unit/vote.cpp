@@ -0,0 +1,142 @@
+//  Copyright (c) 2021 Nikunj Gupta
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <resilient_spaces/resilient_spaces.hpp>
+
+#include <Kokkos_Core.hpp>
+#include <Kokkos_SIMD.hpp>
+
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+using space = Kokkos::DefaultHostExecutionSpace;
+using view_type = Kokkos::View<int*, space>;
+using array_type = Kokkos::Array<double, 3>;
+using simd_type = Kokkos::Experimental::simd<double>;
+
+namespace util = Kokkos::resilience::util;
+
+// Several fields per cell, without operator==
+struct cell
+{
+    double density;
+    double velocity;
+    double energy;
+};
+
+// Replica `attempt` of each index is wrong in field `attempt` if it is
+// below `faults`
+struct multi_field
+{
+    KOKKOS_FUNCTION cell operator()(int i) const
+    {
+        int const attempt = attempts(i)++;
+
+        cell c{1. * i, 2. * i, 3. * i};
+        if (attempt < faults && attempt == 0)
+            c.density = -1.;
+        if (attempt < faults && attempt == 1)
+            c.velocity = -1.;
+        if (attempt < faults && attempt == 2)
+            c.energy = -1.;
+        return c;
+    }
+
+    view_type attempts;
+    int faults;
+};
+
+struct vector_field
+{
+    KOKKOS_FUNCTION simd_type operator()(int i) const
+    {
+        int const attempt = attempts(i)++;
+        return simd_type(attempt == 0 ? -1. : 0.5 * i);
+    }
+
+    view_type attempts;
+};
+
+int main(int argc, char* argv[])
+{
+    Kokkos::initialize(argc, argv);
+
+    bool success = true;
+    {
+        double const nan = std::numeric_limits<double>::quiet_NaN();
+
+        array_type const a{{1., 2., nan}};
+        array_type const b{{9., 2., nan}};
+        array_type const c{{1., 8., nan}};
+        array_type const d{{7., 6., nan}};
+
+        // Lanes are compared bitwise, NaNs agree
+        success = success && util::equal(a, a) && !util::equal(a, b) &&
+            util::agrees(a, b, c) && !util::agrees(b, a, c);
+
+        array_type vote{};
+        success = success && util::majority(a, b, c, vote) &&
+            vote[0] == 1. && vote[1] == 2. && util::equal(vote, a) &&
+            !util::majority(b, c, d, vote);
+
+        cell const x{1., 2., 3.};
+        cell const y{1., 0., 3.};
+        cell z{};
+        success = success && util::majority(x, y, x, z) &&
+            util::equal(z, x) && !util::equal(x, y);
+
+        simd_type const u(1.);
+        simd_type const v(2.);
+        success = success && util::equal(u, u) && !util::equal(u, v) &&
+            util::agrees(u, v, u);
+
+        using replicate = Kokkos::resilience::ResilientReplicate<space>;
+        using range_policy = Kokkos::RangePolicy<replicate>;
+
+        int const n = 1000;
+        space inst{};
+        view_type attempts("attempts", n);
+
+        // Replicas wrong in different fields still have a majority per
+        // field
+        Kokkos::parallel_for(range_policy(replicate(inst), 0, n),
+            multi_field{attempts, 2});
+        Kokkos::fence();
+
+        for (int i = 0; i != n; ++i)
+            success = success && attempts(i) == 3;
+
+        // The third replica is wrong itself
+        Kokkos::deep_copy(attempts, 0);
+        bool caught = false;
+        try
+        {
+            Kokkos::parallel_for(range_policy(replicate(inst), 0, n),
+                multi_field{attempts, 3});
+        }
+        catch (std::runtime_error const&)
+        {
+            caught = true;
+        }
+        success = success && caught;
+
+        // simd results
+        Kokkos::deep_copy(attempts, 0);
+        Kokkos::parallel_for(
+            range_policy(replicate(inst), 0, n), vector_field{attempts});
+        Kokkos::fence();
+
+        for (int i = 0; i != n; ++i)
+            success = success && attempts(i) == 3;
+
+        std::cout << "Execution Complete" << std::endl;
+    }
+
+    Kokkos::finalize();
+
+    return success ? 0 : 1;
+}